@@ -30,41 +30,110 @@
 /**************************************************************************/
 #include "Adafruit_ADS1X15.h"
 
+/** Storage for the data rate tables, which m_sps points into */
+constexpr uint16_t ADS1015_Traits::spsTable[8];
+constexpr uint16_t ADS1115_Traits::spsTable[8];
+
 /**************************************************************************/
 /*!
-    @brief  Instantiates a new ADS1015 class w/appropriate properties
+    @brief  Sets up the state shared by the ADS1015 and ADS1115 classes
 */
 /**************************************************************************/
-Adafruit_ADS1015::Adafruit_ADS1015() {
-  m_bitShift = 4;
-  m_gain = GAIN_TWOTHIRDS; /* +/- 6.144V range (limited to VDD +0.3V max!) */
-  m_dataRate = RATE_ADS1015_1600SPS;
+Adafruit_ADS1X15::Adafruit_ADS1X15()
+#ifdef ARDUINO
+    : m_i2c_storage(ADS1X15_ADDRESS, &Wire), m_i2c_transport(&m_i2c_storage)
+#endif
+{
+  m_transport = NULL;
+  m_bitShift = ADS1115_Traits::bitShift;
+  m_sps = ADS1115_Traits::spsTable;
+  m_timeout = ADS1X15_CONVERSION_TIMEOUT;
+  m_timedOut = false;
+  m_doneTime = 0;
+  invalidateRegisterCache();
+  m_savedTransactions = 0;
+  m_configCount = 0;
+  m_readyCount = 0;
+  m_readyTime = 0;
+  m_readyServiced = 0;
+  m_alertCallback = NULL;
+  memset(m_autoGain, 0, sizeof(m_autoGain));
+  m_regWanted = 0;
+  m_status = ADS1X15_OK;
+  m_lastFailed = false;
+  m_watchdog = false;
+  m_failures = 0;
+  m_breakerThreshold = 0;
+  m_breakerOpen = false;
+  m_breakerCooldown = 0;
+  m_breakerOpened = 0;
+  m_recoveries = 0;
+#ifdef ARDUINO
+  m_sclPin = -1;
+  m_sdaPin = -1;
+#endif
+  m_stats = NULL;
+  m_trace = NULL;
 }
 
+#ifdef ARDUINO
 /**************************************************************************/
 /*!
-    @brief  Instantiates a new ADS1115 class w/appropriate properties
+    @brief  Sets up the HW (reads coefficients values, etc.)
+
+            The I2C device lives inside this object, so nothing is
+            allocated and begin() can safely be called again, e.g. after
+            a bus reset.
+
+    @param i2c_addr I2C address of device
+    @param wire I2C bus
+
+    @return true if successful, otherwise false
 */
 /**************************************************************************/
-Adafruit_ADS1115::Adafruit_ADS1115() {
-  m_bitShift = 0;
-  m_gain = GAIN_TWOTHIRDS; /* +/- 6.144V range (limited to VDD +0.3V max!) */
-  m_dataRate = RATE_ADS1115_128SPS;
+bool Adafruit_ADS1X15::begin(uint8_t i2c_addr, TwoWire *wire) {
+  m_i2c_storage = Adafruit_I2CDevice(i2c_addr, wire);
+  m_i2c_transport = Adafruit_ADS1X15_I2CTransport(&m_i2c_storage, wire);
+  return begin(&m_i2c_transport);
 }
 
 /**************************************************************************/
 /*!
-    @brief  Sets up the HW (reads coefficients values, etc.)
+    @brief  Sets up the HW using an I2C device owned by the caller
 
-    @param i2c_addr I2C address of device
-    @param wire I2C bus
+    @param i2c_dev I2C device for the ADC, which must outlive this object
 
     @return true if successful, otherwise false
 */
 /**************************************************************************/
-bool Adafruit_ADS1X15::begin(uint8_t i2c_addr, TwoWire *wire) {
-  m_i2c_dev = new Adafruit_I2CDevice(i2c_addr, wire);
-  return m_i2c_dev->begin();
+bool Adafruit_ADS1X15::begin(Adafruit_I2CDevice *i2c_dev) {
+  m_i2c_transport = Adafruit_ADS1X15_I2CTransport(i2c_dev);
+  return begin(&m_i2c_transport);
+}
+#endif
+
+/**************************************************************************/
+/*!
+    @brief  Sets up the HW using a transport owned by the caller, e.g.
+            Adafruit_ADS1X15_LinuxI2C on a Linux host
+
+            Any register values the driver has cached are forgotten, so
+            the next writes go out on the bus even if the chip was reset.
+
+    @param transport bus access for the ADC, which must outlive this object
+
+    @return true if successful, otherwise false
+*/
+/**************************************************************************/
+bool Adafruit_ADS1X15::begin(Adafruit_ADS1X15_Transport *transport) {
+  m_transport = transport;
+  m_savedTransactions = 0;
+  m_timedOut = false;
+  invalidateRegisterCache();
+  m_regWanted = 0;
+  clearStatus();
+  recordHealthy();
+  return m_transport->begin();
 }
 
 /**************************************************************************/
@@ -74,7 +143,13 @@ bool Adafruit_ADS1X15::begin(uint8_t i2c_addr, TwoWire *wire) {
     @param gain gain setting to use
 */
 /**************************************************************************/
-void Adafruit_ADS1X15::setGain(adsGain_t gain) { m_gain = gain; }
+void Adafruit_ADS1X15::setGain(adsGain_t gain) {
+  m_gain = gain;
+
+  // Work out the LSB size once here rather than on every conversion
+  m_lsbVolts = computeVolts(1, gain);
+  m_lsbMicrovoltsQ8 = gainScale(gain);
+}
 
 /**************************************************************************/
 /*!
@@ -103,6 +178,48 @@ void Adafruit_ADS1X15::setDataRate(uint16_t rate) { m_dataRate = rate; }
 /**************************************************************************/
 uint16_t Adafruit_ADS1X15::getDataRate() { return m_dataRate; }
 
+/**************************************************************************/
+/*!
+    @brief  Gets the resolution of the conversion results
+
+    @return 12 for the ADS1015, 16 for the ADS1115
+*/
+/**************************************************************************/
+uint8_t Adafruit_ADS1X15::getResolution() { return 16 - m_bitShift; }
+
+/**************************************************************************/
+/*!
+    @brief  Sets how long the blocking reads wait for a conversion before
+            giving up
+
+    @param timeout_ms timeout in milliseconds
+*/
+/**************************************************************************/
+void Adafruit_ADS1X15::setConversionTimeout(uint16_t timeout_ms) {
+  m_timeout = timeout_ms;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gets the conversion timeout used by the blocking reads
+
+    @return the timeout in milliseconds
+*/
+/**************************************************************************/
+uint16_t Adafruit_ADS1X15::getConversionTimeout() { return m_timeout; }
+
+/**************************************************************************/
+/*!
+    @brief  Gets the nominal time one conversion takes at the current
+            data rate
+
+    @return the conversion time in microseconds
+*/
+/**************************************************************************/
+uint32_t Adafruit_ADS1X15::getConversionDelay() {
+  return conversionDelay(m_dataRate);
+}
+
 /**************************************************************************/
 /*!
     @brief  Gets a single-ended ADC reading from the specified channel
@@ -113,18 +230,62 @@ uint16_t Adafruit_ADS1X15::getDataRate() { return m_dataRate; }
 */
 /**************************************************************************/
 int16_t Adafruit_ADS1X15::readADC_SingleEnded(uint8_t channel) {
+  int16_t counts;
+  readADC_SingleEnded(channel, &counts);
+  return counts;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gets a single-ended ADC reading from the specified channel,
+            reporting why the reading failed if it did
+
+    @param channel ADC channel to read
+    @param counts set to the ADC reading, 0 on failure
+
+    @return ADS1X15_OK, or the reason the reading failed
+*/
+/**************************************************************************/
+adsStatus_t Adafruit_ADS1X15::readADC_SingleEnded(uint8_t channel,
+                                                  int16_t *counts) {
   if (channel > 3) {
-    return 0;
+    *counts = 0;
+    m_status = ADS1X15_ERR_ARGUMENT;
+    return m_status;
+  }
+  return readADC(MUX_BY_CHANNEL[channel], counts);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gets a single-shot ADC reading of any mux setting. Worst-case
+            time is bounded by the conversion timeout, or with the
+            watchdog on by the data rate, plus one recovery.
+
+    @param mux mux field value, e.g. ADS1X15_REG_CONFIG_MUX_DIFF_0_1
+    @param counts set to the ADC reading, 0 on failure
+
+    @return ADS1X15_OK, or the reason the reading failed
+*/
+/**************************************************************************/
+adsStatus_t Adafruit_ADS1X15::readADC(uint16_t mux, int16_t *counts) {
+  *counts = 0;
+  if (!startRead()) {
+    return m_status;
   }
 
-  startADCReading(MUX_BY_CHANNEL[channel], /*continuous=*/false);
+  startADCReading(mux, /*continuous=*/false);
 
   // Wait for the conversion to complete
-  while (!conversionComplete())
-    ;
+  if (m_status == ADS1X15_OK && waitForConversion()) {
+    // Read the conversion results
+    int16_t res = readCounts();
+    if (m_status == ADS1X15_OK) {
+      *counts = res;
+    }
+  }
 
-  // Read the conversion results
-  return getLastConversionResults();
+  return finishRead();
 }
 
 /**************************************************************************/
@@ -138,14 +299,9 @@ int16_t Adafruit_ADS1X15::readADC_SingleEnded(uint8_t channel) {
 */
 /**************************************************************************/
 int16_t Adafruit_ADS1X15::readADC_Differential_0_1() {
-  startADCReading(ADS1X15_REG_CONFIG_MUX_DIFF_0_1, /*continuous=*/false);
-
-  // Wait for the conversion to complete
-  while (!conversionComplete())
-    ;
-
-  // Read the conversion results
-  return getLastConversionResults();
+  int16_t counts;
+  readADC(ADS1X15_REG_CONFIG_MUX_DIFF_0_1, &counts);
+  return counts;
 }
 
 /**************************************************************************/
@@ -158,14 +314,9 @@ int16_t Adafruit_ADS1X15::readADC_Differential_0_1() {
 */
 /**************************************************************************/
 int16_t Adafruit_ADS1X15::readADC_Differential_0_3() {
-  startADCReading(ADS1X15_REG_CONFIG_MUX_DIFF_0_3, /*continuous=*/false);
-
-  // Wait for the conversion to complete
-  while (!conversionComplete())
-    ;
-
-  // Read the conversion results
-  return getLastConversionResults();
+  int16_t counts;
+  readADC(ADS1X15_REG_CONFIG_MUX_DIFF_0_3, &counts);
+  return counts;
 }
 
 /**************************************************************************/
@@ -178,14 +329,9 @@ int16_t Adafruit_ADS1X15::readADC_Differential_0_3() {
 */
 /**************************************************************************/
 int16_t Adafruit_ADS1X15::readADC_Differential_1_3() {
-  startADCReading(ADS1X15_REG_CONFIG_MUX_DIFF_1_3, /*continuous=*/false);
-
-  // Wait for the conversion to complete
-  while (!conversionComplete())
-    ;
-
-  // Read the conversion results
-  return getLastConversionResults();
+  int16_t counts;
+  readADC(ADS1X15_REG_CONFIG_MUX_DIFF_1_3, &counts);
+  return counts;
 }
 
 /**************************************************************************/
@@ -199,14 +345,220 @@ int16_t Adafruit_ADS1X15::readADC_Differential_1_3() {
 */
 /**************************************************************************/
 int16_t Adafruit_ADS1X15::readADC_Differential_2_3() {
-  startADCReading(ADS1X15_REG_CONFIG_MUX_DIFF_2_3, /*continuous=*/false);
+  int16_t counts;
+  readADC(ADS1X15_REG_CONFIG_MUX_DIFF_2_3, &counts);
+  return counts;
+}
 
-  // Wait for the conversion to complete
-  while (!conversionComplete())
-    ;
+/**************************************************************************/
+/*!
+    @brief  Gets a reading at whatever gain suits the signal, see the
+            status-returning version
+
+    @param mux mux field value
+    @param counts if not NULL, receives the reading in raw counts
+    @param gain if not NULL, receives the gain the reading was taken with
+
+    @return the reading in volts, or 0 on failure
+*/
+/**************************************************************************/
+float Adafruit_ADS1X15::readADC_AutoRange(uint16_t mux, int16_t *counts,
+                                          adsGain_t *gain) {
+  float volts;
+  readADC_AutoRange(mux, &volts, counts, gain);
+  return volts;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gets a reading at whatever gain suits the signal, reporting
+            why the reading failed if it did. Each mux setting remembers
+            the gain its last reading used; the reading is only repeated
+            (at a wider range) if it saturated. The gain for the next
+            reading is stepped down when the result is above 7/8 of full
+            scale, and up when it is below 3/8. A failed reading leaves
+            the remembered gain alone.
+
+    @param mux mux field value
+    @param volts set to the reading in volts, 0 on failure
+    @param counts if not NULL, set to the reading in raw counts, 0 on
+           failure
+    @param gain if not NULL, set to the gain the reading was taken with.
+           Left alone on failure.
+
+    @return ADS1X15_OK, or the reason the reading failed
+*/
+/**************************************************************************/
+adsStatus_t Adafruit_ADS1X15::readADC_AutoRange(uint16_t mux, float *volts,
+                                                int16_t *counts,
+                                                adsGain_t *gain) {
+  *volts = 0;
+  if (counts != NULL) {
+    *counts = 0;
+  }
+  if (!startRead()) {
+    return m_status;
+  }
+
+  uint8_t pga = getAutoRangeGain(mux) >> 9;
+  int32_t fullScale = 0x7FFF >> m_bitShift;
+  int16_t res = 0;
+
+  while (true) {
+    startConversion(mux, (adsGain_t)(pga << 9), m_dataRate,
+                    /*continuous=*/false);
+    if (m_status != ADS1X15_OK || !waitForConversion()) {
+      break;
+    }
+    res = readCounts();
+    if (m_status != ADS1X15_OK) {
+      break;
+    }
+
+    // Only convert again if the reading clipped and there is a wider
+    // range left to try
+    bool saturated = (res >= fullScale) || (res < -fullScale);
+    if (!saturated || pga == 0) {
+      break;
+    }
+    pga--;
+  }
+
+  if (m_status == ADS1X15_OK) {
+    // Choose the gain for next time. The PGA steps are 2x apart (1.5x
+    // for the widest), so the gap between 3/8 and 7/8 keeps a steady
+    // signal from bouncing between two gains.
+    int32_t mag = (res < 0) ? -(int32_t)res : res;
+    uint8_t next = pga;
+    if (mag > fullScale - fullScale / 8 && pga > 0) {
+      next = pga - 1;
+    } else if (mag < (fullScale * 3) / 8 && pga < (GAIN_SIXTEEN >> 9)) {
+      next = pga + 1;
+    }
+    setAutoRangeGain(mux, (adsGain_t)(next << 9));
+
+    adsGain_t used = (adsGain_t)(pga << 9);
+    *volts = computeVolts(res, used);
+    if (counts != NULL) {
+      *counts = res;
+    }
+    if (gain != NULL) {
+      *gain = used;
+    }
+  }
+
+  return finishRead();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Sets the gain readADC_AutoRange() will try first for a mux
+            setting, e.g. to restore a known range after a reset
+
+    @param mux mux field value
+    @param gain gain setting
+*/
+/**************************************************************************/
+void Adafruit_ADS1X15::setAutoRangeGain(uint16_t mux, adsGain_t gain) {
+  // The PGA codes fit in a nibble, so two mux settings share a byte
+  uint8_t idx = (mux & ADS1X15_REG_CONFIG_MUX_MASK) >> 12;
+  uint8_t shift = (idx & 1) * 4;
+  m_autoGain[idx >> 1] &= ~(0x0F << shift);
+  m_autoGain[idx >> 1] |= (gain >> 9) << shift;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gets the gain readADC_AutoRange() will try first for a mux
+            setting
+
+    @param mux mux field value
+
+    @return the gain setting
+*/
+/**************************************************************************/
+adsGain_t Adafruit_ADS1X15::getAutoRangeGain(uint16_t mux) {
+  uint8_t idx = (mux & ADS1X15_REG_CONFIG_MUX_MASK) >> 12;
+  uint8_t pga = (m_autoGain[idx >> 1] >> ((idx & 1) * 4)) & 0x0F;
+  return (adsGain_t)(pga << 9);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Collects n fresh conversions from one mux setting. The ADC
+            is switched to continuous mode once, no conversion is read
+            twice, and the ADC is powered down at the end.
+
+            With ready given, every reading waits for ALERT/RDY, so the
+            readings are n consecutive conversions at the chip's own rate.
+            Without it, reads are paced by a timer at 1.1x the nominal
+            conversion time, to stay behind an oscillator running up to
+            10% slow. A chip at its nominal rate then skips about one
+            conversion in ten, and the spacing between readings jitters
+            as the timer drifts against the chip. Use the ready flag when
+            the readings must be evenly spaced, e.g. for RMS or spectra.
+
+    @param mux mux field value
+    @param out array the readings are stored in
+    @param n number of readings to take
+    @param ready optional flag set by an ALERT/RDY interrupt handler. If
+           given, each reading waits for the flag (and clears it) instead
+           of pacing reads by the timer.
+
+    @return the number of readings stored. This is less than n if
+            waiting for ALERT/RDY timed out or a read failed, and
+            getStatus() then says which; the readings before it are good.
+*/
+/**************************************************************************/
+size_t Adafruit_ADS1X15::readBurst(uint16_t mux, int16_t *out, size_t n,
+                                   volatile bool *ready) {
+  if (out == NULL || n == 0) {
+    return 0;
+  }
+
+  // Allow for the internal oscillator running up to 10% slow, so every
+  // read sees a conversion the previous read didn't
+  uint32_t period = getConversionDelay();
+  period += period / 10;
 
-  // Read the conversion results
-  return getLastConversionResults();
+  if (ready != NULL) {
+    *ready = false;
+  }
+  m_timedOut = false;
+  if (!startRead()) {
+    return 0;
+  }
+  startADCReading(mux, /*continuous=*/true);
+  if (m_status != ADS1X15_OK) {
+    finishRead();
+    return 0;
+  }
+  uint32_t next = micros() + period;
+
+  size_t i;
+  for (i = 0; i < n; i++) {
+    if (ready != NULL) {
+      uint32_t start = millis();
+      while (!*ready && !m_timedOut) {
+        m_timedOut = (millis() - start >= m_timeout);
+      }
+      if (m_timedOut) {
+        recordFailure(ADS1X15_ERR_TIMEOUT);
+        break;
+      }
+      *ready = false;
+    } else {
+      while ((int32_t)(micros() - next) < 0)
+        ;
+      next += period;
+    }
+    if (getLastConversionResults(&out[i]) != ADS1X15_OK) {
+      break;
+    }
+  }
+
+  powerDown();
+  return i;
 }
 
 /**************************************************************************/
@@ -223,6 +575,10 @@ int16_t Adafruit_ADS1X15::readADC_Differential_2_3() {
 /**************************************************************************/
 void Adafruit_ADS1X15::startComparator_SingleEnded(uint8_t channel,
                                                    int16_t threshold) {
+  if (channel > 3) {
+    return;
+  }
+
   // Start with default values
   uint16_t config =
       ADS1X15_REG_CONFIG_CQUE_1CONV |   // Comparator enabled and asserts on 1
@@ -247,6 +603,122 @@ void Adafruit_ADS1X15::startComparator_SingleEnded(uint8_t channel,
 
   // Write config register to the ADC
   writeRegister(ADS1X15_REG_POINTER_CONFIG, config);
+
+  // Thresholds no longer match the RDY mode values startADCReading() expects
+  invalidateRegisterCache();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Sets up the comparator with full control over its behaviour,
+            and starts continuous conversions.
+
+            In traditional mode ALERT/RDY asserts when the reading goes
+            above highThreshold, and de-asserts when it drops below
+            lowThreshold. In window mode it asserts while the reading is
+            outside lowThreshold..highThreshold.
+
+    @param mux mux field value, single-ended or differential
+    @param lowThreshold low threshold in counts
+    @param highThreshold high threshold in counts
+    @param mode ADS1X15_REG_CONFIG_CMODE_TRAD or
+           ADS1X15_REG_CONFIG_CMODE_WINDOW
+    @param polarity ADS1X15_REG_CONFIG_CPOL_ACTVLOW or
+           ADS1X15_REG_CONFIG_CPOL_ACTVHI
+    @param latch ADS1X15_REG_CONFIG_CLAT_LATCH to hold ALERT/RDY until the
+           conversion register is read, or ADS1X15_REG_CONFIG_CLAT_NONLAT
+    @param queue assert after 1, 2 or 4 conversions beyond the threshold,
+           ADS1X15_REG_CONFIG_CQUE_1CONV/_2CONV/_4CONV
+
+    @return true if the comparator was started, false if the settings
+            are invalid
+*/
+/**************************************************************************/
+bool Adafruit_ADS1X15::startComparator(uint16_t mux, int16_t lowThreshold,
+                                       int16_t highThreshold, uint16_t mode,
+                                       uint16_t polarity, uint16_t latch,
+                                       uint16_t queue) {
+  int16_t limit = 0x7FFF >> m_bitShift;
+  if (lowThreshold > highThreshold || highThreshold > limit ||
+      lowThreshold < -limit - 1 || queue == ADS1X15_REG_CONFIG_CQUE_NONE) {
+    return false;
+  }
+
+  uint16_t config = (mux & ADS1X15_REG_CONFIG_MUX_MASK) |
+                    (mode & ADS1X15_REG_CONFIG_CMODE_MASK) |
+                    (polarity & ADS1X15_REG_CONFIG_CPOL_MASK) |
+                    (latch & ADS1X15_REG_CONFIG_CLAT_MASK) |
+                    (queue & ADS1X15_REG_CONFIG_CQUE_MASK) |
+                    ADS1X15_REG_CONFIG_MODE_CONTIN | m_gain | m_dataRate;
+
+  // Thresholds go first, so the comparator never runs against stale ones.
+  // Shift 12-bit thresholds left 4 bits for the ADS1015.
+  writeRegister(ADS1X15_REG_POINTER_LOWTHRESH, lowThreshold << m_bitShift);
+  writeRegister(ADS1X15_REG_POINTER_HITHRESH, highThreshold << m_bitShift);
+  writeRegister(ADS1X15_REG_POINTER_CONFIG, config);
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Sets up the comparator like startComparator(), with the
+            thresholds given in volts at the current gain.
+
+    @param mux mux field value, single-ended or differential
+    @param lowVolts low threshold in volts
+    @param highVolts high threshold in volts
+    @param mode comparator mode, see startComparator()
+    @param polarity ALERT/RDY polarity, see startComparator()
+    @param latch latching, see startComparator()
+    @param queue conversions before asserting, see startComparator()
+
+    @return true if the comparator was started, false if the settings
+            are invalid
+*/
+/**************************************************************************/
+bool Adafruit_ADS1X15::startComparatorVolts(uint16_t mux, float lowVolts,
+                                            float highVolts, uint16_t mode,
+                                            uint16_t polarity, uint16_t latch,
+                                            uint16_t queue) {
+  return startComparator(mux, computeCounts(lowVolts), computeCounts(highVolts),
+                         mode, polarity, latch, queue);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Sets the function serviceAlert() calls when the comparator
+            asserts ALERT/RDY
+
+    @param callback function taking the reading that tripped the
+           comparator, or NULL for none
+*/
+/**************************************************************************/
+void Adafruit_ADS1X15::setAlertCallback(adsAlertCallback_t callback) {
+  m_alertCallback = callback;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Handles ALERT edges recorded by dataReadyISR() while the
+            comparator is running. Reads the conversion register, which
+            also clears a latched alert, and passes the reading to the
+            alert callback. Call this from loop().
+
+    @return true if an alert was handled
+*/
+/**************************************************************************/
+bool Adafruit_ADS1X15::serviceAlert() {
+  uint8_t count = m_readyCount;
+  if (count == m_readyServiced) {
+    return false;
+  }
+  m_readyServiced = count;
+
+  int16_t counts = getLastConversionResults();
+  if (m_alertCallback != NULL) {
+    m_alertCallback(counts);
+  }
+  return true;
 }
 
 /**************************************************************************/
@@ -259,19 +731,57 @@ void Adafruit_ADS1X15::startComparator_SingleEnded(uint8_t channel,
 */
 /**************************************************************************/
 int16_t Adafruit_ADS1X15::getLastConversionResults() {
-  // Read the conversion results
-  uint16_t res = readRegister(ADS1X15_REG_POINTER_CONVERT) >> m_bitShift;
-  if (m_bitShift == 0) {
-    return (int16_t)res;
-  } else {
-    // Shift 12-bit results right 4 bits for the ADS1015,
-    // making sure we keep the sign bit intact
-    if (res > 0x07FF) {
-      // negative number - extend the sign to 16th bit
-      res |= 0xF000;
-    }
-    return (int16_t)res;
+  return readCounts();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Reads the last conversion results, reporting why the read
+            failed if it did
+
+    @param counts set to the last ADC reading, 0 on failure
+
+    @return ADS1X15_OK, or the reason the read failed
+*/
+/**************************************************************************/
+adsStatus_t Adafruit_ADS1X15::getLastConversionResults(int16_t *counts) {
+  *counts = 0;
+  if (!startRead()) {
+    return m_status;
+  }
+  int16_t res = readCounts();
+  if (m_status == ADS1X15_OK) {
+    *counts = res;
   }
+  return finishRead();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Reads the conversion register as a signed 16-bit value,
+            before any shift for the ADS1015
+
+    @return the raw conversion register
+*/
+/**************************************************************************/
+int16_t Adafruit_ADS1X15::readConversion() {
+  int16_t res = (int16_t)readRegister(ADS1X15_REG_POINTER_CONVERT);
+  recordLatency();
+  return res;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Reads the conversion register and aligns the result. Every
+            conversion read goes through here.
+
+    @return the last ADC reading
+*/
+/**************************************************************************/
+int16_t Adafruit_ADS1X15::readCounts() {
+  // Shift 12-bit results right 4 bits for the ADS1015; the arithmetic
+  // shift keeps the sign bit intact
+  return readConversion() >> m_bitShift;
 }
 
 /**************************************************************************/
@@ -284,9 +794,24 @@ int16_t Adafruit_ADS1X15::getLastConversionResults() {
 */
 /**************************************************************************/
 float Adafruit_ADS1X15::computeVolts(int16_t counts) {
+  return counts * m_lsbVolts;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Compute volts for the given raw counts, taken at the given
+            gain rather than the current one.
+
+    @param counts the ADC reading in raw counts
+    @param gain the gain setting the reading was taken with
+
+    @return the ADC reading in volts
+*/
+/**************************************************************************/
+float Adafruit_ADS1X15::computeVolts(int16_t counts, adsGain_t gain) {
   // see data sheet Table 3
   float fsRange;
-  switch (m_gain) {
+  switch (gain) {
   case GAIN_TWOTHIRDS:
     fsRange = 6.144f;
     break;
@@ -313,51 +838,523 @@ float Adafruit_ADS1X15::computeVolts(int16_t counts) {
 
 /**************************************************************************/
 /*!
-    @brief  Non-blocking start conversion function
-
-    Call getLastConversionResults() once conversionComplete() returns true.
-    In continuous mode, getLastConversionResults() will always return the
-    latest result.
-    ALERT/RDY pin is set to RDY mode, and a 8us pulse is generated every
-    time new data is ready.
+    @brief  Compute volts for a buffer of raw counts taken at the current
+            gain.
 
-    @param mux mux field value
-    @param continuous continuous if set, otherwise single shot
+    @param counts the ADC readings in raw counts
+    @param volts array the readings in volts are stored in
+    @param n number of readings
 */
 /**************************************************************************/
-void Adafruit_ADS1X15::startADCReading(uint16_t mux, bool continuous) {
-  // Start with default values
-  uint16_t config =
-      ADS1X15_REG_CONFIG_CQUE_1CONV |   // Set CQUE to any value other than
-                                        // None so we can use it in RDY mode
-      ADS1X15_REG_CONFIG_CLAT_NONLAT |  // Non-latching (default val)
-      ADS1X15_REG_CONFIG_CPOL_ACTVLOW | // Alert/Rdy active low   (default val)
-      ADS1X15_REG_CONFIG_CMODE_TRAD;    // Traditional comparator (default val)
-
-  if (continuous) {
-    config |= ADS1X15_REG_CONFIG_MODE_CONTIN;
-  } else {
-    config |= ADS1X15_REG_CONFIG_MODE_SINGLE;
+void Adafruit_ADS1X15::computeVolts(const int16_t *counts, float *volts,
+                                    size_t n) {
+  const float lsb = m_lsbVolts;
+  for (size_t i = 0; i < n; i++) {
+    volts[i] = counts[i] * lsb;
   }
+}
 
-  // Set PGA/voltage range
-  config |= m_gain;
+/**************************************************************************/
+/*!
+    @brief  Compute raw counts for the given voltage at the current gain,
+            e.g. for comparator thresholds.
 
-  // Set data rate
-  config |= m_dataRate;
+    @param volts the voltage
 
-  // Set channels
-  config |= mux;
+    @return the voltage in raw counts, clamped to the ADC's range
+*/
+/**************************************************************************/
+int16_t Adafruit_ADS1X15::computeCounts(float volts) {
+  if (m_lsbVolts == 0) {
+    return 0;
+  }
+  float counts = volts / m_lsbVolts;
+  float limit = 0x7FFF >> m_bitShift;
+  if (counts >= limit) {
+    return limit;
+  }
+  if (counts <= -limit - 1) {
+    return -limit - 1;
+  }
+  return (int16_t)lroundf(counts);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Compute microvolts for the given raw counts, using integer
+            arithmetic only.
+
+    @param counts the ADC reading in raw counts
+
+    @return the ADC reading in microvolts, rounded to the nearest
+*/
+/**************************************************************************/
+int32_t Adafruit_ADS1X15::computeMicrovolts(int16_t counts) {
+  uint8_t shift = 8 - m_bitShift;
+  return ((int32_t)counts * m_lsbMicrovoltsQ8 + (1 << (shift - 1))) >> shift;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Compute microvolts for the given raw counts, taken at the
+            given gain rather than the current one.
+
+    @param counts the ADC reading in raw counts
+    @param gain the gain setting the reading was taken with
+
+    @return the ADC reading in microvolts, rounded to the nearest
+*/
+/**************************************************************************/
+int32_t Adafruit_ADS1X15::computeMicrovolts(int16_t counts, adsGain_t gain) {
+  uint8_t shift = 8 - m_bitShift;
+  return ((int32_t)counts * gainScale(gain) + (1 << (shift - 1))) >> shift;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Compute microvolts for a buffer of raw counts taken at the
+            current gain, using integer arithmetic only.
+
+    @param counts the ADC readings in raw counts
+    @param microvolts array the readings in microvolts are stored in
+    @param n number of readings
+*/
+/**************************************************************************/
+void Adafruit_ADS1X15::computeMicrovolts(const int16_t *counts,
+                                         int32_t *microvolts, size_t n) {
+  const int32_t scale = m_lsbMicrovoltsQ8;
+  const uint8_t shift = 8 - m_bitShift;
+  const int32_t round = 1 << (shift - 1);
+  for (size_t i = 0; i < n; i++) {
+    microvolts[i] = ((int32_t)counts[i] * scale + round) >> shift;
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Non-blocking start conversion function
+
+    Call getLastConversionResults() once conversionComplete() returns true.
+    In continuous mode, getLastConversionResults() will always return the
+    latest result.
+    ALERT/RDY pin is set to RDY mode, and a 8us pulse is generated every
+    time new data is ready.
+
+    @param mux mux field value
+    @param continuous continuous if set, otherwise single shot
+*/
+/**************************************************************************/
+void Adafruit_ADS1X15::startADCReading(uint16_t mux, bool continuous) {
+  startConversion(mux, m_gain, m_dataRate, continuous);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Starts a single-shot conversion and fills in a handle that
+            records its mux, gain, data rate and start time. Poll the
+            handle with pollAsync().
+
+    @param conv handle to fill in
+    @param mux mux field value
+    @param callback optional function pollAsync() calls when the
+           conversion finishes, times out, is superseded or can't be read
+*/
+/**************************************************************************/
+void Adafruit_ADS1X15::startAsync(adsConversion_t *conv, uint16_t mux,
+                                  adsConversionCallback_t callback) {
+  conv->mux = mux;
+  conv->gain = m_gain;
+  conv->rate = m_dataRate;
+  conv->callback = callback;
+  conv->counts = 0;
+  conv->volts = 0;
+  conv->state = ADS1X15_CONV_PENDING;
+
+  startConversion(mux, conv->gain, conv->rate, /*continuous=*/false);
+  conv->id = m_configCount;
+  conv->start = micros();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Checks on a conversion started by startAsync(), without
+            blocking. The bus isn't touched until the conversion could be
+            finished. Once done, the result is scaled with the gain the
+            conversion was started with, whatever the current gain is.
+
+    @param conv handle filled in by startAsync()
+    @param dataReady set if ALERT/RDY already signalled the end of the
+           conversion, which skips polling the OS bit
+
+    @return the handle's state
+*/
+/**************************************************************************/
+adsConvState_t Adafruit_ADS1X15::pollAsync(adsConversion_t *conv,
+                                           bool dataReady) {
+  if (conv->state != ADS1X15_CONV_PENDING) {
+    return conv->state;
+  }
+
+  uint32_t elapsed = micros() - conv->start;
+  uint32_t wait = conversionDelay(conv->rate);
+  if (conv->id != m_configCount) {
+    conv->state = ADS1X15_CONV_SUPERSEDED;
+  } else if (!dataReady &&
+             (elapsed < wait - wait / 10 || !conversionComplete())) {
+    if (elapsed < m_timeout * 1000UL) {
+      return ADS1X15_CONV_PENDING;
+    }
+    conv->state = ADS1X15_CONV_TIMEOUT;
+  } else if (getLastConversionResults(&conv->counts) != ADS1X15_OK) {
+    conv->state = ADS1X15_CONV_ERROR;
+  } else {
+    conv->volts = computeVolts(conv->counts, conv->gain);
+    conv->state = ADS1X15_CONV_DONE;
+  }
+
+  if (conv->callback != NULL) {
+    conv->callback(conv);
+  }
+  return conv->state;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Writes the config register to start a conversion with the
+            given settings, and puts ALERT/RDY in RDY mode
+
+    @param mux mux field value
+    @param gain gain setting to use
+    @param rate data rate to use
+    @param continuous continuous if set, otherwise single shot
+*/
+/**************************************************************************/
+void Adafruit_ADS1X15::startConversion(uint16_t mux, adsGain_t gain,
+                                       uint16_t rate, bool continuous) {
+  // Start with default values
+  uint16_t config =
+      ADS1X15_REG_CONFIG_CQUE_1CONV |   // Set CQUE to any value other than
+                                        // None so we can use it in RDY mode
+      ADS1X15_REG_CONFIG_CLAT_NONLAT |  // Non-latching (default val)
+      ADS1X15_REG_CONFIG_CPOL_ACTVLOW | // Alert/Rdy active low   (default val)
+      ADS1X15_REG_CONFIG_CMODE_TRAD;    // Traditional comparator (default val)
+
+  if (continuous) {
+    config |= ADS1X15_REG_CONFIG_MODE_CONTIN;
+  } else {
+    config |= ADS1X15_REG_CONFIG_MODE_SINGLE;
+  }
+
+  // Set PGA/voltage range
+  config |= gain;
+
+  // Set data rate
+  config |= rate;
+
+  // Set channels
+  config |= mux;
 
   // Set 'start single-conversion' bit
   config |= ADS1X15_REG_CONFIG_OS_SINGLE;
 
   // Write config register to the ADC
   writeRegister(ADS1X15_REG_POINTER_CONFIG, config);
+  if (m_stats != NULL) {
+    m_stats->started = micros();
+    m_stats->pending = true;
+  }
+
+  // Set ALERT/RDY to RDY mode. These only need to go out on the bus the
+  // first time, or after something else has changed them.
+  writeRegisterCached(ADS1X15_REG_POINTER_HITHRESH, 0x8000);
+  writeRegisterCached(ADS1X15_REG_POINTER_LOWTHRESH, 0x0000);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Picks the next step of a smooth weighted round robin scan:
+            every step each channel earns credit in proportion to its
+            steps, and the channel with the most credit goes next. After
+            total steps the credits are back where they started.
 
-  // Set ALERT/RDY to RDY mode.
-  writeRegister(ADS1X15_REG_POINTER_HITHRESH, 0x8000);
-  writeRegister(ADS1X15_REG_POINTER_LOWTHRESH, 0x0000);
+    @param credit credit of each channel, updated
+    @param steps steps per cycle of each channel
+    @param count number of channels
+    @param total steps per cycle
+
+    @return the channel that goes next
+*/
+/**************************************************************************/
+static uint8_t nextScanStep(int16_t *credit, const uint8_t *steps,
+                            uint8_t count, uint16_t total) {
+  uint8_t pick = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    credit[i] += steps[i];
+    if (credit[i] > credit[pick]) {
+      pick = i;
+    }
+  }
+  credit[pick] -= total;
+  return pick;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Finds the longest time from the start of one of each channel's
+            scan steps to the start of its next, wrapping around the end
+            of the table
+
+    @param steps steps per cycle of each channel
+    @param stepTime time one step of each channel takes in us
+    @param count number of channels
+    @param total steps per cycle
+    @param gap set to the longest gap of each channel in us
+*/
+/**************************************************************************/
+static void longestScanGaps(const uint8_t *steps, const uint32_t *stepTime,
+                            uint8_t count, uint16_t total, uint32_t *gap) {
+  int16_t credit[ADS1X15_SCAN_TARGETS] = {0};
+  uint32_t last[ADS1X15_SCAN_TARGETS];
+  uint32_t now = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    gap[i] = 0;
+  }
+  // Run the table twice and measure in the second pass, so the gap
+  // across the end of the table counts too
+  for (uint16_t s = 0; s < 2 * total; s++) {
+    uint8_t pick = nextScanStep(credit, steps, count, total);
+    if (s >= total && now - last[pick] > gap[pick]) {
+      gap[pick] = now - last[pick];
+    }
+    last[pick] = now;
+    now += stepTime[pick];
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Plans a scan for channels that need different sample rates,
+            e.g. a temperature at 8 SPS next to a current at 400 SPS
+
+            Each channel gets the slowest (lowest noise) data rate that
+            keeps up with it. The table repeats the slowest channel once
+            and every other channel often enough to meet its rate, with
+            the steps of each channel spread evenly through the table. If
+            the table takes longer than the slowest channel's period, the
+            channel taking the most time is moved to a faster rate until
+            it fits. Then, while the other steps falling between two of a
+            channel's steps hold it past its period, the channel with the
+            longest steps is moved to a faster rate. Step times allow for
+            the +/-10% oscillator tolerance and ADS1X15_SCAN_OVERHEAD of
+            bus time.
+
+            Pass the table to Adafruit_ADS1X15_Scan::start(). If the plan
+            is feasible, no channel waits longer than its period between
+            two samples.
+
+    @param targets channels and their sample rates, the chosen data rate
+           is written back to each
+    @param count number of channels, at most ADS1X15_SCAN_TARGETS
+    @param table where to write the scan steps
+    @param size number of steps table holds
+    @param length set to the number of steps written, 0 if the table is
+           too small
+    @param load if not NULL, set to the fraction of the cycle the steps
+           take, above 1 if they cannot fit, 0 if the targets are
+           rejected before planning
+
+    @return true if every channel can get its sample rate on this chip
+*/
+/**************************************************************************/
+bool Adafruit_ADS1X15::planScan(adsScanTarget_t *targets, uint8_t count,
+                                adsScanEntry_t *table, uint8_t size,
+                                uint8_t *length, float *load) {
+  *length = 0;
+  if (load != NULL) {
+    *load = 0;
+  }
+  if (count == 0 || count > ADS1X15_SCAN_TARGETS) {
+    return false;
+  }
+
+  // The ADS1015's top two rate codes are both 3300SPS, so take the
+  // lower one
+  const uint16_t *sps = m_sps;
+  uint8_t fastest = 7;
+  while (fastest > 0 && sps[fastest - 1] == sps[fastest]) {
+    fastest--;
+  }
+
+  float slowest = targets[0].hz;
+  for (uint8_t i = 1; i < count; i++) {
+    if (targets[i].hz < slowest) {
+      slowest = targets[i].hz;
+    }
+  }
+  if (!(slowest > 0)) {
+    return false;
+  }
+
+  // Steps per cycle, and the slowest data rate that keeps up with each
+  // channel on its own. The rate index is the data rate field >> 5.
+  uint8_t steps[ADS1X15_SCAN_TARGETS];
+  uint8_t level[ADS1X15_SCAN_TARGETS];
+  uint16_t total = 0;
+  bool feasible = true;
+  for (uint8_t i = 0; i < count; i++) {
+    float n = ceilf(targets[i].hz / slowest);
+    if (n > size) {
+      return false;
+    }
+    steps[i] = (uint8_t)n;
+    total += steps[i];
+
+    level[i] = 0;
+    while (level[i] < fastest && sps[level[i]] < targets[i].hz) {
+      level[i]++;
+    }
+    if (sps[level[i]] < targets[i].hz) {
+      feasible = false;
+    }
+  }
+  if (total > size) {
+    return false;
+  }
+
+  // Speed up the channel costing the most time until the cycle fits
+  // within the slowest channel's period, then the channel with the
+  // longest steps until no channel waits too long between samples
+  float cycle = 1000000.0f / slowest;
+  float used;
+  bool late;
+  while (true) {
+    uint32_t stepTime[ADS1X15_SCAN_TARGETS];
+    used = 0;
+    late = false;
+    uint8_t worst = count;
+    float worstTime = 0;
+    for (uint8_t i = 0; i < count; i++) {
+      stepTime[i] = conversionDelay(level[i] << 5);
+      stepTime[i] += stepTime[i] / 10 + ADS1X15_SCAN_OVERHEAD;
+      float time = (float)steps[i] * stepTime[i];
+      used += time;
+      if (level[i] < fastest && time > worstTime) {
+        worst = i;
+        worstTime = time;
+      }
+    }
+    if (used <= cycle) {
+      uint32_t gap[ADS1X15_SCAN_TARGETS];
+      longestScanGaps(steps, stepTime, count, total, gap);
+      for (uint8_t i = 0; i < count; i++) {
+        if (gap[i] > 1000000.0f / targets[i].hz) {
+          late = true;
+        }
+      }
+      if (!late) {
+        break;
+      }
+      worst = count;
+      for (uint8_t i = 0; i < count; i++) {
+        if (level[i] < fastest &&
+            (worst == count || stepTime[i] > stepTime[worst])) {
+          worst = i;
+        }
+      }
+    }
+    if (worst == count) {
+      break;
+    }
+    level[worst]++;
+  }
+  if (used > cycle || late) {
+    feasible = false;
+  }
+  if (load != NULL) {
+    *load = used / cycle;
+  }
+
+  for (uint8_t i = 0; i < count; i++) {
+    targets[i].rate = level[i] << 5;
+  }
+
+  int16_t credit[ADS1X15_SCAN_TARGETS] = {0};
+  for (uint16_t s = 0; s < total; s++) {
+    uint8_t pick = nextScanStep(credit, steps, count, total);
+    table[s] = adsScanEntry_t(targets[pick].mux, targets[pick].gain,
+                              targets[pick].rate);
+  }
+  *length = total;
+
+  return feasible;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Linearly interpolates (or extrapolates) between two readings
+            of the same signal.
+
+    @param before the earlier reading
+    @param after the later reading
+    @param timestamp micros() value to estimate the reading at
+
+    @return the estimated reading in counts
+*/
+/**************************************************************************/
+int16_t Adafruit_ADS1X15::interpolateSample(const adsSample_t *before,
+                                            const adsSample_t *after,
+                                            uint32_t timestamp) {
+  int32_t span = (int32_t)(after->timestamp - before->timestamp);
+  if (span <= 0) {
+    return after->counts;
+  }
+  int32_t offset = (int32_t)(timestamp - before->timestamp);
+  int32_t delta = (int32_t)after->counts - before->counts;
+  int32_t res = before->counts + (int32_t)((int64_t)delta * offset / span);
+  if (res > 32767) {
+    return 32767;
+  }
+  if (res < -32768) {
+    return -32768;
+  }
+  return res;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Records an ALERT/RDY edge, for serviceAlert(), a scan or a
+            stream. Call this from the interrupt handler attached to the
+            ALERT/RDY pin; it does not touch the I2C bus.
+*/
+/**************************************************************************/
+void Adafruit_ADS1X15::dataReadyISR() {
+  m_readyTime = micros();
+  ADS1X15_BARRIER();
+  m_readyCount++;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gets the edges recorded by dataReadyISR() and the time of the
+            latest one. The ISR can fire while the 32-bit timestamp is
+            being copied, which takes several instructions on an 8-bit
+            MCU, so this reads until the edge count shows a consistent
+            pair.
+
+    @param timestamp set to micros() of the latest edge
+
+    @return the number of edges seen, wrapping at 256
+*/
+/**************************************************************************/
+uint8_t Adafruit_ADS1X15::readyEdges(uint32_t *timestamp) {
+  uint8_t count;
+  do {
+    count = m_readyCount;
+    ADS1X15_BARRIER();
+    *timestamp = m_readyTime;
+    ADS1X15_BARRIER();
+  } while (count != m_readyCount);
+  return count;
 }
 
 /**************************************************************************/
@@ -368,7 +1365,525 @@ void Adafruit_ADS1X15::startADCReading(uint16_t mux, bool continuous) {
 */
 /**************************************************************************/
 bool Adafruit_ADS1X15::conversionComplete() {
-  return (readRegister(ADS1X15_REG_POINTER_CONFIG) & 0x8000) != 0;
+  if (m_stats != NULL) {
+    m_stats->pollIterations++;
+  }
+  uint16_t config = readRegister(ADS1X15_REG_POINTER_CONFIG);
+  if (m_lastFailed || (config & 0x8000) == 0) {
+    return false;
+  }
+  m_doneTime = micros();
+  recordHealthy();
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Waits for the conversion started by startADCReading() to
+            finish. Sleeps for most of the expected conversion time, then
+            polls the OS bit until it is set or the timeout expires.
+
+    @return true if the conversion completed, false on timeout
+*/
+/**************************************************************************/
+bool Adafruit_ADS1X15::waitForConversion() {
+  uint32_t start = micros();
+  uint32_t wait = getConversionDelay();
+  uint32_t limit = (uint32_t)m_timeout * 1000UL;
+  if (m_watchdog) {
+    // Past the slowest the oscillator can run, the conversion is stuck
+    uint32_t deadline = wait + wait / 10 + ADS1X15_WATCHDOG_SLACK;
+    if (deadline < limit) {
+      limit = deadline;
+    }
+  }
+
+  // The internal oscillator is only good to +/-10%, so don't expect a
+  // result before 90% of the nominal conversion time
+  wait -= wait / 10;
+  delay(wait / 1000);
+  delayMicroseconds(wait % 1000);
+
+  while (!conversionComplete()) {
+    if (m_lastFailed) {
+      // The bus failed, polling on would only fail again
+      m_timedOut = true;
+      return false;
+    }
+    if (micros() - start >= limit) {
+      m_timedOut = true;
+      recordFailure(ADS1X15_ERR_TIMEOUT);
+      return false;
+    }
+  }
+
+  m_timedOut = false;
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Returns true if the last waitForConversion(), including the
+            one inside the blocking reads, gave up waiting, either on
+            timeout or because the bus failed.
+
+    @return True if the last conversion timed out, false otherwise.
+*/
+/**************************************************************************/
+bool Adafruit_ADS1X15::conversionTimedOut() { return m_timedOut; }
+
+/**************************************************************************/
+/*!
+    @brief  Gets the first error since clearStatus(). The status-returning
+            reads clear it first, so this reports on the non-blocking
+            paths too, e.g. scans, streams and readBurst().
+
+    @return ADS1X15_OK, or the first error seen
+*/
+/**************************************************************************/
+adsStatus_t Adafruit_ADS1X15::getStatus() { return m_status; }
+
+/**************************************************************************/
+/*!
+    @brief  Clears the error reported by getStatus()
+*/
+/**************************************************************************/
+void Adafruit_ADS1X15::clearStatus() { m_status = ADS1X15_OK; }
+
+/**************************************************************************/
+/*!
+    @brief  Turns the bus watchdog on or off. With it on, a conversion not
+            finished by the slowest the oscillator can run (plus
+            ADS1X15_WATCHDOG_SLACK) counts as stuck rather than waiting
+            out the conversion timeout, and a failed read or a stuck scan
+            step is followed by recover().
+
+    @param enable true to turn the watchdog on
+*/
+/**************************************************************************/
+void Adafruit_ADS1X15::setWatchdog(bool enable) { m_watchdog = enable; }
+
+/**************************************************************************/
+/*!
+    @brief  Sets up the circuit breaker. After threshold consecutive
+            failed transactions or stuck conversions, the driver stops
+            using the bus for cooldown_ms, so a dead chip doesn't take bus
+            time from the others on the bus. Reads during that time fail
+            at once with ADS1X15_ERR_OFFLINE. The first read after it
+            tries recover(); a completed conversion closes the breaker.
+
+    @param threshold failures that open the breaker, 0 to never open it
+    @param cooldown_ms how long the breaker stays open
+*/
+/**************************************************************************/
+void Adafruit_ADS1X15::setCircuitBreaker(uint8_t threshold,
+                                         uint16_t cooldown_ms) {
+  m_breakerThreshold = threshold;
+  m_breakerCooldown = cooldown_ms;
+  if (threshold == 0) {
+    m_breakerOpen = false;
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Checks whether the circuit breaker has opened. It stays open
+            until a conversion completes.
+
+    @return true if the breaker is open
+*/
+/**************************************************************************/
+bool Adafruit_ADS1X15::circuitOpen() { return m_breakerOpen; }
+
+/**************************************************************************/
+/*!
+    @brief  Gets the number of failures since the last completed
+            conversion
+
+    @return consecutive failed transactions and stuck conversions
+*/
+/**************************************************************************/
+uint8_t Adafruit_ADS1X15::getConsecutiveFailures() { return m_failures; }
+
+/**************************************************************************/
+/*!
+    @brief  Gets the number of recoveries attempted since power up
+
+    @return recover() attempts
+*/
+/**************************************************************************/
+uint32_t Adafruit_ADS1X15::getRecoveries() { return m_recoveries; }
+
+/**************************************************************************/
+/*!
+    @brief  Tries to bring the chip back after a bus failure, in bounded
+            time: ends the bus, clears it if setBusClearPins() was called,
+            begins the bus again, then restores the thresholds and config
+            the driver last set. A conversion in progress is lost.
+
+            Beginning the bus again puts its clock back to the default, so
+            a sketch that called Wire.setClock() should call it again
+            after getRecoveries() goes up.
+
+    @return true if every step succeeded, false if any failed or begin()
+            has not been called
+*/
+/**************************************************************************/
+bool Adafruit_ADS1X15::recover() {
+  // Nothing to recover before begin()
+  if (m_transport == NULL || !busAvailable()) {
+    return false;
+  }
+  m_recoveries++;
+
+  // Release the pins, so the bus clear isn't fighting the I2C peripheral
+  // for them, and so the peripheral is set up from scratch afterwards
+  m_transport->end();
+#ifdef ARDUINO
+  if (m_sclPin >= 0 && m_sdaPin >= 0) {
+    clearBus();
+  }
+#endif
+
+  // The chip may have reset, so nothing in the cache can be trusted
+  uint16_t regs[4];
+  memcpy(regs, m_regCache, sizeof(regs));
+  invalidateRegisterCache();
+
+  if (!m_transport->begin()) {
+    recordFailure(ADS1X15_ERR_BUS);
+    return false;
+  }
+
+  // Thresholds first, as the config write starts continuous mode or the
+  // comparator again. Leave the OS bit clear so no single-shot starts.
+  bool ok = true;
+  for (uint8_t reg = ADS1X15_REG_POINTER_LOWTHRESH;
+       ok && reg <= ADS1X15_REG_POINTER_HITHRESH; reg++) {
+    if (m_regWanted & (1 << reg)) {
+      ok = writeRegister(reg, regs[reg]);
+    }
+  }
+  if (ok && (m_regWanted & (1 << ADS1X15_REG_POINTER_CONFIG))) {
+    ok = writeRegister(ADS1X15_REG_POINTER_CONFIG,
+                       regs[ADS1X15_REG_POINTER_CONFIG] &
+                           ~ADS1X15_REG_CONFIG_OS_MASK);
+  }
+  return ok;
+}
+
+#ifdef ARDUINO
+/**************************************************************************/
+/*!
+    @brief  Sets the pins recover() uses to clear a bus held low by a chip
+            stuck part way through a byte
+
+    @param scl SCL pin number, or -1
+    @param sda SDA pin number, or -1
+*/
+/**************************************************************************/
+void Adafruit_ADS1X15::setBusClearPins(int8_t scl, int8_t sda) {
+  m_sclPin = scl;
+  m_sdaPin = sda;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Clocks SCL until a stuck chip lets go of SDA, at most nine
+            times, then sends a STOP. Lines are driven low or released to
+            their pull-ups, never driven high.
+*/
+/**************************************************************************/
+void Adafruit_ADS1X15::clearBus() {
+  pinMode(m_sdaPin, INPUT_PULLUP);
+  pinMode(m_sclPin, INPUT_PULLUP);
+  for (uint8_t i = 0; i < 9 && digitalRead(m_sdaPin) == LOW; i++) {
+    pinMode(m_sclPin, OUTPUT);
+    digitalWrite(m_sclPin, LOW);
+    delayMicroseconds(5);
+    pinMode(m_sclPin, INPUT_PULLUP);
+    delayMicroseconds(5);
+  }
+
+  // STOP: SDA rises while SCL is high
+  pinMode(m_sclPin, OUTPUT);
+  digitalWrite(m_sclPin, LOW);
+  pinMode(m_sdaPin, OUTPUT);
+  digitalWrite(m_sdaPin, LOW);
+  delayMicroseconds(5);
+  pinMode(m_sclPin, INPUT_PULLUP);
+  delayMicroseconds(5);
+  pinMode(m_sdaPin, INPUT_PULLUP);
+  delayMicroseconds(5);
+}
+#endif
+
+/**************************************************************************/
+/*!
+    @brief  Starts a status-returning read. If the circuit breaker has
+            cooled down, recovers the chip before trusting it again.
+
+    @return false if the read can't go ahead, with m_status set
+*/
+/**************************************************************************/
+bool Adafruit_ADS1X15::startRead() {
+  clearStatus();
+  if (!busAvailable()) {
+    return false;
+  }
+  if (m_breakerOpen && !recover()) {
+    return false;
+  }
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Finishes a status-returning read. With the watchdog on, a
+            failed read is followed by recover() so the next one has a
+            chance, unless the circuit breaker has opened.
+
+    @return the read's status
+*/
+/**************************************************************************/
+adsStatus_t Adafruit_ADS1X15::finishRead() {
+  if (m_status == ADS1X15_OK) {
+    recordHealthy();
+  } else if (m_watchdog && !m_breakerOpen) {
+    recover();
+  }
+  return m_status;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Checks the circuit breaker before a bus transaction
+
+    @return false if the breaker is open and cooling down
+*/
+/**************************************************************************/
+bool Adafruit_ADS1X15::busAvailable() {
+  if (m_breakerOpen && millis() - m_breakerOpened < m_breakerCooldown) {
+    m_lastFailed = true;
+    if (m_status == ADS1X15_OK) {
+      m_status = ADS1X15_ERR_OFFLINE;
+    }
+    return false;
+  }
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Notes a failed transaction or stuck conversion, opening the
+            circuit breaker once there have been too many in a row
+
+    @param status what went wrong
+*/
+/**************************************************************************/
+void Adafruit_ADS1X15::recordFailure(adsStatus_t status) {
+  if (m_status == ADS1X15_OK) {
+    m_status = status;
+  }
+  if (m_failures < 0xFF) {
+    m_failures++;
+  }
+  if (m_breakerThreshold != 0 && m_failures >= m_breakerThreshold) {
+    m_breakerOpen = true;
+    m_breakerOpened = millis();
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Notes that the chip is working, closing the circuit breaker
+*/
+/**************************************************************************/
+void Adafruit_ADS1X15::recordHealthy() {
+  m_failures = 0;
+  m_breakerOpen = false;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Returns the number of register writes that were skipped
+            because the device already held the requested value, including
+            pointer register updates skipped by readRegister().
+
+    @return number of I2C transactions saved since begin()
+*/
+/**************************************************************************/
+uint32_t Adafruit_ADS1X15::getSavedTransactions() {
+  return m_savedTransactions;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Starts counting bus activity into a stats block: register
+            reads and writes, conversionComplete() polls, failed
+            transactions and a histogram of conversion start to result
+            latency. The block is cleared first.
+
+    @param stats counters owned by the caller, which must outlive the
+           driver or be detached first, or NULL to stop counting
+*/
+/**************************************************************************/
+void Adafruit_ADS1X15::setStats(adsStats_t *stats) {
+  if (stats != NULL) {
+    memset(stats, 0, sizeof(*stats));
+  }
+  m_stats = stats;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Adds the time since the last conversion was started to the
+            latency histogram, once per conversion
+*/
+/**************************************************************************/
+void Adafruit_ADS1X15::recordLatency() {
+  if (m_stats == NULL || !m_stats->pending) {
+    return;
+  }
+  m_stats->pending = false;
+
+  uint32_t t = (micros() - m_stats->started) >> 9;
+  uint8_t bucket = 0;
+  while (t != 0 && bucket < ADS1X15_LATENCY_BUCKETS - 1) {
+    t >>= 1;
+    bucket++;
+  }
+  m_stats->latency[bucket]++;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Starts recording every register read and write into a trace,
+            e.g. to capture the polling pattern of a field unit and play
+            it back on a host with Adafruit_ADS1X15_ReplayTransport.
+            Fill in the trace's entries and size; the count and dropped
+            fields are cleared here. Recording stops when it is full.
+
+    @param trace recording owned by the caller, which must outlive the
+           driver or be detached first, or NULL to stop tracing
+*/
+/**************************************************************************/
+void Adafruit_ADS1X15::setTrace(adsTrace_t *trace) {
+  if (trace != NULL) {
+    trace->count = 0;
+    trace->dropped = 0;
+  }
+  m_trace = trace;
+}
+
+#ifdef ARDUINO
+/**************************************************************************/
+/*!
+    @brief  Prints the recorded transactions as CSV lines of
+            timestamp,reg,value,flags for tools/ads1x15_trace.cpp
+
+    @param out where to print, e.g. Serial
+*/
+/**************************************************************************/
+void Adafruit_ADS1X15::dumpTrace(Print &out) {
+  out.println("timestamp,reg,value,flags");
+  if (m_trace == NULL) {
+    return;
+  }
+  for (uint16_t i = 0; i < m_trace->count; i++) {
+    const adsTraceEntry_t &e = m_trace->entries[i];
+    out.print(e.timestamp);
+    out.print(",");
+    out.print(e.reg);
+    out.print(",");
+    out.print(e.value);
+    out.print(",");
+    out.println(e.flags);
+  }
+}
+#endif
+
+/**************************************************************************/
+/*!
+    @brief  Records one register transaction, if tracing
+
+    @param reg register pointer
+    @param value value written or read
+    @param flags ADS1X15_TRACE_* bits
+*/
+/**************************************************************************/
+void Adafruit_ADS1X15::traceRegister(uint8_t reg, uint16_t value,
+                                     uint8_t flags) {
+  if (m_trace == NULL) {
+    return;
+  }
+  if (m_trace->count >= m_trace->size) {
+    m_trace->dropped++;
+    return;
+  }
+  adsTraceEntry_t *e = &m_trace->entries[m_trace->count++];
+  e->timestamp = micros();
+  e->value = value;
+  e->reg = reg;
+  e->flags = flags;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Puts the ADC back in power-down single-shot mode, stopping
+            continuous conversions
+*/
+/**************************************************************************/
+void Adafruit_ADS1X15::powerDown() {
+  uint16_t config = m_regCache[ADS1X15_REG_POINTER_CONFIG];
+  config &= ~ADS1X15_REG_CONFIG_OS_MASK;
+  config |= ADS1X15_REG_CONFIG_MODE_SINGLE;
+  writeRegister(ADS1X15_REG_POINTER_CONFIG, config);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gets the size of a 16-bit LSB at a gain setting
+
+    @param gain gain setting
+
+    @return the LSB size in microvolts, as 24.8 fixed point. This is the
+            full-scale range in microvolts / 128, an exact integer for
+            every gain.
+*/
+/**************************************************************************/
+uint16_t Adafruit_ADS1X15::gainScale(adsGain_t gain) {
+  // see data sheet Table 3
+  switch (gain) {
+  case GAIN_TWOTHIRDS:
+    return 6144000 / 128;
+  case GAIN_ONE:
+    return 4096000 / 128;
+  case GAIN_TWO:
+    return 2048000 / 128;
+  case GAIN_FOUR:
+    return 1024000 / 128;
+  case GAIN_EIGHT:
+    return 512000 / 128;
+  case GAIN_SIXTEEN:
+    return 256000 / 128;
+  default:
+    return 0;
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gets the nominal time one conversion takes at a data rate
+
+    @param rate data rate code
+
+    @return the conversion time in microseconds
+*/
+/**************************************************************************/
+uint32_t Adafruit_ADS1X15::conversionDelay(uint16_t rate) {
+  uint16_t hz = m_sps[(rate & ADS1X15_REG_CONFIG_RATE_MASK) >> 5];
+  return (1000000UL + hz - 1) / hz;
 }
 
 /**************************************************************************/
@@ -377,13 +1892,72 @@ bool Adafruit_ADS1X15::conversionComplete() {
 
     @param reg register address to write to
     @param value value to write to register
+
+    @return true if the chip acknowledged the write
 */
 /**************************************************************************/
-void Adafruit_ADS1X15::writeRegister(uint8_t reg, uint16_t value) {
+bool Adafruit_ADS1X15::writeRegister(uint8_t reg, uint16_t value) {
+  uint8_t idx = reg & ADS1X15_REG_POINTER_MASK;
+  // Remember the value even if the write fails, for recover()
+  m_regCache[idx] = value;
+  m_regCacheValid &= ~(1 << idx);
+  m_regWanted |= (1 << idx);
+  if (reg == ADS1X15_REG_POINTER_CONFIG) {
+    // Outstanding async handles no longer own the conversion register
+    m_configCount++;
+  }
+  if (!busAvailable()) {
+    return false;
+  }
+
   buffer[0] = reg;
   buffer[1] = value >> 8;
   buffer[2] = value & 0xFF;
-  m_i2c_dev->write(buffer, 3);
+  bool ok = m_transport->write(buffer, 3);
+  m_lastFailed = !ok;
+  if (ok) {
+    m_pointer = reg;
+    m_regCacheValid |= (1 << idx);
+  } else {
+    m_pointer = 0xFF; // unknown, forces the next pointer write
+    recordFailure(ADS1X15_ERR_BUS);
+  }
+  if (m_stats != NULL) {
+    m_stats->regWrites++;
+    m_stats->i2cErrors += !ok;
+  }
+  traceRegister(reg, value, ok ? 0 : ADS1X15_TRACE_ERROR);
+  return ok;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Writes 16-bits to the specified destination register, unless
+            the shadow copy shows the register already holds that value
+
+    @param reg register address to write to
+    @param value value to write to register
+*/
+/**************************************************************************/
+void Adafruit_ADS1X15::writeRegisterCached(uint8_t reg, uint16_t value) {
+  uint8_t idx = reg & ADS1X15_REG_POINTER_MASK;
+  if ((m_regCacheValid & (1 << idx)) && m_regCache[idx] == value) {
+    m_savedTransactions++;
+    return;
+  }
+  writeRegister(reg, value);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Forgets the shadow copy of the device registers, so the next
+            write to each register (and the next pointer update) goes out
+            on the bus
+*/
+/**************************************************************************/
+void Adafruit_ADS1X15::invalidateRegisterCache() {
+  m_regCacheValid = 0;
+  m_pointer = 0xFF; // not a valid register, forces the next pointer write
 }
 
 /**************************************************************************/
@@ -392,12 +1966,39 @@ void Adafruit_ADS1X15::writeRegister(uint8_t reg, uint16_t value) {
 
     @param reg register address to read from
 
-    @return 16 bit register value read
+    @return 16 bit register value read, 0 if the read failed
 */
 /**************************************************************************/
 uint16_t Adafruit_ADS1X15::readRegister(uint8_t reg) {
-  buffer[0] = reg;
-  m_i2c_dev->write(buffer, 1);
-  m_i2c_dev->read(buffer, 2);
-  return ((buffer[0] << 8) | buffer[1]);
+  // The pointer register keeps its value between transactions, so
+  // back-to-back reads of the same register can skip the pointer write
+  if (!busAvailable()) {
+    return 0;
+  }
+
+  bool ok;
+  uint8_t flags = ADS1X15_TRACE_READ;
+  if (m_pointer != reg) {
+    // Transports that can do a repeated START send the pointer and read
+    // the register in one transaction
+    ok = m_transport->writeThenRead(&reg, 1, buffer, 2);
+    m_pointer = ok ? reg : 0xFF;
+    flags |= ADS1X15_TRACE_POINTER;
+  } else {
+    m_savedTransactions++;
+    ok = m_transport->read(buffer, 2);
+  }
+  m_lastFailed = !ok;
+  if (!ok) {
+    flags |= ADS1X15_TRACE_ERROR;
+    recordFailure(ADS1X15_ERR_BUS);
+  }
+  if (m_stats != NULL) {
+    m_stats->regReads++;
+    m_stats->i2cErrors += !ok;
+  }
+  uint16_t value = (buffer[0] << 8) | buffer[1];
+  traceRegister(reg, value, flags);
+  // Don't pass on whatever was left in the buffer
+  return ok ? value : 0;
 }
@@ -16,9 +16,15 @@
 #ifndef __ADS1X15_H__
 #define __ADS1X15_H__
 
+#include "Adafruit_ADS1X15_Filter.h"
+#include "Adafruit_ADS1X15_Transport.h"
+#ifdef ARDUINO
 #include <Adafruit_I2CDevice.h>
 #include <Arduino.h>
 #include <Wire.h>
+#else
+#include "Adafruit_ADS1X15_Host.h"
+#endif
 
 /*=========================================================================
     I2C ADDRESS/BITS
@@ -26,6 +32,27 @@
 #define ADS1X15_ADDRESS (0x48) ///< 1001 000 (ADDR = GND)
 /*=========================================================================*/
 
+/*=========================================================================
+    MEMORY ORDERING
+    -----------------------------------------------------------------------*/
+#if defined(__ATOMIC_SEQ_CST)
+/** Orders memory accesses across this point between an ISR, loop() and
+    tasks on other cores. Emits a fence on dual-core ESP32 and Cortex-M,
+    only a compiler barrier on AVR. */
+#define ADS1X15_BARRIER() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#else
+/** Stops the compiler moving memory accesses across this point */
+#define ADS1X15_BARRIER() __asm__ __volatile__("" ::: "memory")
+#endif
+/*=========================================================================*/
+
+/*=========================================================================
+    TIMING
+    -----------------------------------------------------------------------*/
+#define ADS1X15_CONVERSION_TIMEOUT                                             \
+  (250) ///< Default ms to wait for a conversion (2x slowest data rate)
+/*=========================================================================*/
+
 /*=========================================================================
     POINTER REGISTER
     -----------------------------------------------------------------------*/
@@ -140,6 +167,199 @@ typedef enum {
 #define RATE_ADS1115_475SPS (0x00C0) ///< 475 samples per second
 #define RATE_ADS1115_860SPS (0x00E0) ///< 860 samples per second
 
+/** ADS1015 data rates, for compile-time checked Adafruit_ADS1015 use */
+typedef enum {
+  ADS1015_RATE_128SPS = RATE_ADS1015_128SPS,
+  ADS1015_RATE_250SPS = RATE_ADS1015_250SPS,
+  ADS1015_RATE_490SPS = RATE_ADS1015_490SPS,
+  ADS1015_RATE_920SPS = RATE_ADS1015_920SPS,
+  ADS1015_RATE_1600SPS = RATE_ADS1015_1600SPS,
+  ADS1015_RATE_2400SPS = RATE_ADS1015_2400SPS,
+  ADS1015_RATE_3300SPS = RATE_ADS1015_3300SPS
+} ads1015Rate_t;
+
+/** ADS1115 data rates, for compile-time checked Adafruit_ADS1115 use */
+typedef enum {
+  ADS1115_RATE_8SPS = RATE_ADS1115_8SPS,
+  ADS1115_RATE_16SPS = RATE_ADS1115_16SPS,
+  ADS1115_RATE_32SPS = RATE_ADS1115_32SPS,
+  ADS1115_RATE_64SPS = RATE_ADS1115_64SPS,
+  ADS1115_RATE_128SPS = RATE_ADS1115_128SPS,
+  ADS1115_RATE_250SPS = RATE_ADS1115_250SPS,
+  ADS1115_RATE_475SPS = RATE_ADS1115_475SPS,
+  ADS1115_RATE_860SPS = RATE_ADS1115_860SPS
+} ads1115Rate_t;
+
+/** Scan step rate meaning the rate set by Adafruit_ADS1X15::setDataRate() */
+#define ADS1X15_RATE_DEFAULT (0xFFFF)
+
+/** One step of a channel scan, see Adafruit_ADS1X15_Scan::start() */
+struct adsScanEntry_t {
+  uint16_t mux;   ///< mux field value, e.g. MUX_BY_CHANNEL[0]
+  adsGain_t gain; ///< gain setting used for this step
+  uint16_t rate;  ///< data rate used for this step, or ADS1X15_RATE_DEFAULT
+
+  /*!
+      @brief  Creates a scan step, e.g. { MUX_BY_CHANNEL[0], GAIN_ONE }
+      @param mux mux field value
+      @param gain gain setting
+      @param rate data rate, left out to follow setDataRate()
+  */
+  constexpr adsScanEntry_t(uint16_t mux = 0, adsGain_t gain = GAIN_TWOTHIRDS,
+                           uint16_t rate = ADS1X15_RATE_DEFAULT)
+      : mux(mux), gain(gain), rate(rate) {}
+};
+
+#define ADS1X15_SCAN_TARGETS (8) ///< Most channels planScan() accepts
+#ifndef ADS1X15_SCAN_OVERHEAD
+/** Bus time per scan step in us, for planScan(). About right at 400kHz,
+    raise it for a 100kHz bus. */
+#define ADS1X15_SCAN_OVERHEAD (300)
+#endif
+
+/** Sample rate one channel needs, see Adafruit_ADS1X15::planScan() */
+typedef struct {
+  uint16_t mux;   ///< mux field value, e.g. MUX_BY_CHANNEL[0]
+  adsGain_t gain; ///< gain setting for the channel
+  float hz;       ///< samples per second the channel needs
+  uint16_t rate;  ///< data rate chosen by planScan()
+} adsScanTarget_t;
+
+/*=========================================================================
+    INSTRUMENTATION
+    -----------------------------------------------------------------------
+    Pass a stats block to Adafruit_ADS1X15::setStats() to count bus
+    activity, or a trace to Adafruit_ADS1X15::setTrace() to record
+    register transactions. Both belong to the caller, so a driver that is
+    not instrumented only carries two NULL pointers, and the class layout
+    is the same whatever the sketch or the library is built with.
+    -----------------------------------------------------------------------*/
+#define ADS1X15_LATENCY_BUCKETS (10) ///< Number of latency histogram buckets
+
+/** Bus activity counters, see Adafruit_ADS1X15::setStats() */
+typedef struct {
+  uint32_t regReads;       ///< Register reads
+  uint32_t regWrites;      ///< Register writes
+  uint32_t pollIterations; ///< conversionComplete() calls
+  uint32_t i2cErrors;      ///< Failed I2C reads and writes
+  /** Conversion start to result read latency. Bucket n counts latencies
+      below 512us << n, the last bucket counts everything slower. */
+  uint32_t latency[ADS1X15_LATENCY_BUCKETS];
+  uint32_t started; ///< micros() when the last conversion started
+  bool pending;     ///< Latency of the last conversion not yet recorded
+} adsStats_t;
+
+/** Register transaction recording, see Adafruit_ADS1X15::setTrace() */
+typedef struct {
+  adsTraceEntry_t *entries; ///< Buffer transactions are recorded in
+  uint16_t size;            ///< Entries the buffer holds
+  uint16_t count;           ///< Entries recorded
+  uint32_t dropped;         ///< Transactions not recorded, buffer full
+} adsTrace_t;
+/*=========================================================================*/
+
+/** Called by Adafruit_ADS1X15::serviceAlert() with the tripping reading */
+typedef void (*adsAlertCallback_t)(int16_t counts);
+
+/** Result of a read, see Adafruit_ADS1X15::getStatus() */
+typedef enum {
+  ADS1X15_OK,           ///< Success
+  ADS1X15_ERR_ARGUMENT, ///< Invalid channel
+  ADS1X15_ERR_BUS,      ///< A bus transaction failed, e.g. NACK
+  ADS1X15_ERR_TIMEOUT,  ///< The conversion did not finish in time
+  ADS1X15_ERR_OFFLINE   ///< Circuit breaker open, the bus was not used
+} adsStatus_t;
+
+#ifndef ADS1X15_WATCHDOG_SLACK
+/** Time in us the watchdog allows past the slowest possible conversion
+    before calling it stuck, to cover the polling transactions */
+#define ADS1X15_WATCHDOG_SLACK (2000)
+#endif
+
+/** Progress of an adsConversion_t */
+typedef enum {
+  ADS1X15_CONV_PENDING,    ///< Conversion still running
+  ADS1X15_CONV_DONE,       ///< Result is in counts/volts
+  ADS1X15_CONV_SUPERSEDED, ///< Device was reconfigured before the result
+  ADS1X15_CONV_TIMEOUT,    ///< Conversion did not finish in time
+  ADS1X15_CONV_ERROR       ///< Result could not be read, see getStatus()
+} adsConvState_t;
+
+struct adsConversion;
+
+/** Called by Adafruit_ADS1X15::pollAsync() when a conversion finishes */
+typedef void (*adsConversionCallback_t)(struct adsConversion *conv);
+
+/** An asynchronous conversion, see Adafruit_ADS1X15::startAsync() */
+typedef struct adsConversion {
+  uint16_t mux;                     ///< mux field value converted
+  adsGain_t gain;                   ///< gain setting used
+  uint16_t rate;                    ///< data rate used
+  uint32_t start;                   ///< micros() when it was started
+  uint32_t id;                      ///< Device conversion it belongs to
+  adsConvState_t state;             ///< Progress
+  int16_t counts;                   ///< Result in raw counts, when done
+  float volts;                      ///< Result in volts, when done
+  adsConversionCallback_t callback; ///< Called when it finishes, or NULL
+} adsConversion_t;
+
+/** A conversion result with its input and the time it became ready */
+typedef struct {
+  uint32_t timestamp; ///< micros() when the result was seen to be ready
+  int16_t counts;     ///< ADC reading in raw counts
+  uint16_t mux;       ///< mux field value the reading was taken with
+} adsSample_t;
+
+/**************************************************************************/
+/*!
+    @brief  Compile-time properties of the ADS1015
+*/
+/**************************************************************************/
+struct ADS1015_Traits {
+  typedef ads1015Rate_t rate_t;          ///< Data rates this chip supports
+  typedef ads1115Rate_t other_rate_t;    ///< Data rates of the other chip
+  static constexpr uint8_t bitShift = 4; ///< 12-bit result, left aligned
+  /** Data rate selected by the constructor */
+  static constexpr uint16_t defaultRate = RATE_ADS1015_1600SPS;
+  /** Samples per second for each data rate code, indexed by rate >> 5 */
+  static constexpr uint16_t spsTable[8] = {128,  250,  490,  920,
+                                           1600, 2400, 3300, 3300};
+
+  /*!
+      @brief  Gets samples per second at a data rate
+      @param rate data rate code
+      @return samples per second
+  */
+  static constexpr uint16_t sps(uint16_t rate) {
+    return spsTable[(rate & ADS1X15_REG_CONFIG_RATE_MASK) >> 5];
+  }
+};
+
+/**************************************************************************/
+/*!
+    @brief  Compile-time properties of the ADS1115
+*/
+/**************************************************************************/
+struct ADS1115_Traits {
+  typedef ads1115Rate_t rate_t;          ///< Data rates this chip supports
+  typedef ads1015Rate_t other_rate_t;    ///< Data rates of the other chip
+  static constexpr uint8_t bitShift = 0; ///< 16-bit result
+  /** Data rate selected by the constructor */
+  static constexpr uint16_t defaultRate = RATE_ADS1115_128SPS;
+  /** Samples per second for each data rate code, indexed by rate >> 5 */
+  static constexpr uint16_t spsTable[8] = {8,   16,  32,  64,
+                                           128, 250, 475, 860};
+
+  /*!
+      @brief  Gets samples per second at a data rate
+      @param rate data rate code
+      @return samples per second
+  */
+  static constexpr uint16_t sps(uint16_t rate) {
+    return spsTable[(rate & ADS1X15_REG_CONFIG_RATE_MASK) >> 5];
+  }
+};
+
 /**************************************************************************/
 /*!
     @brief  Sensor driver for the Adafruit ADS1X15 ADC breakouts.
@@ -148,54 +368,220 @@ typedef enum {
 class Adafruit_ADS1X15 {
 protected:
   // Instance-specific properties
-  Adafruit_I2CDevice *m_i2c_dev; ///< I2C bus device
-  uint8_t m_bitShift;            ///< bit shift amount
-  adsGain_t m_gain;              ///< ADC gain
-  uint16_t m_dataRate;           ///< Data rate
+  Adafruit_ADS1X15_Transport *m_transport; ///< Bus the chip is reached over
+#ifdef ARDUINO
+  Adafruit_I2CDevice m_i2c_storage;              ///< Default I2C device
+  Adafruit_ADS1X15_I2CTransport m_i2c_transport; ///< Default m_transport
+#endif
+  uint8_t m_bitShift;         ///< bit shift amount
+  const uint16_t *m_sps;      ///< The chip's Traits::spsTable
+  adsGain_t m_gain;           ///< ADC gain
+  uint16_t m_dataRate;        ///< Data rate
+  float m_lsbVolts;           ///< Volts per count at m_gain
+  uint16_t m_lsbMicrovoltsQ8; ///< 16-bit LSB in uV at m_gain, Q8
+  uint16_t m_timeout;         ///< Conversion timeout in ms
+  bool m_timedOut;            ///< Last conversion wait timed out
+  uint32_t m_doneTime;        ///< micros() when OS bit was last seen set
+
+  // Register cache
+  uint16_t m_regCache[4];       ///< Shadow copy of written registers
+  uint8_t m_regCacheValid;      ///< Bit per register valid in m_regCache
+  uint32_t m_savedTransactions; ///< Bus transactions skipped by the cache
+  uint8_t m_pointer;            ///< Last value written to the pointer reg
+  uint32_t m_configCount;       ///< Config register writes, for handles
+  uint8_t m_regWanted;          ///< Bit per register the driver has set
+
+  // Bus health
+  adsStatus_t m_status;       ///< First error since clearStatus()
+  bool m_lastFailed;          ///< The last transaction failed
+  bool m_watchdog;            ///< Stuck conversion detection and recovery
+  uint8_t m_failures;         ///< Consecutive failures
+  uint8_t m_breakerThreshold; ///< Failures that open the breaker, 0 = never
+  bool m_breakerOpen;         ///< The breaker has opened
+  uint16_t m_breakerCooldown; ///< ms the breaker stays open
+  uint32_t m_breakerOpened;   ///< millis() when the breaker last opened
+  uint32_t m_recoveries;      ///< recover() attempts
+#ifdef ARDUINO
+  int8_t m_sclPin; ///< SCL pin for bus clear, or -1
+  int8_t m_sdaPin; ///< SDA pin for bus clear, or -1
+#endif
+
+  // ALERT/RDY state
+  volatile uint8_t m_readyCount;      ///< ALERT/RDY edges seen
+  volatile uint32_t m_readyTime;      ///< micros() of the last edge
+  uint8_t m_readyServiced;            ///< Edges handled by serviceAlert()
+  adsAlertCallback_t m_alertCallback; ///< Called by serviceAlert()
+
+  uint8_t m_autoGain[4]; ///< Auto-range PGA code per mux setting, 2 per byte
+  adsStats_t *m_stats;   ///< Bus activity counters, or NULL
+  adsTrace_t *m_trace;   ///< Transaction recording, or NULL
 
 public:
+  Adafruit_ADS1X15();
+#ifdef ARDUINO
   bool begin(uint8_t i2c_addr = ADS1X15_ADDRESS, TwoWire *wire = &Wire);
+  bool begin(Adafruit_I2CDevice *i2c_dev);
+#endif
+  bool begin(Adafruit_ADS1X15_Transport *transport);
   int16_t readADC_SingleEnded(uint8_t channel);
+  adsStatus_t readADC_SingleEnded(uint8_t channel, int16_t *counts);
+  adsStatus_t readADC(uint16_t mux, int16_t *counts);
   int16_t readADC_Differential_0_1();
   int16_t readADC_Differential_0_3();
   int16_t readADC_Differential_1_3();
   int16_t readADC_Differential_2_3();
+  float readADC_AutoRange(uint16_t mux, int16_t *counts = NULL,
+                          adsGain_t *gain = NULL);
+  adsStatus_t readADC_AutoRange(uint16_t mux, float *volts,
+                                int16_t *counts = NULL, adsGain_t *gain = NULL);
+  void setAutoRangeGain(uint16_t mux, adsGain_t gain);
+  adsGain_t getAutoRangeGain(uint16_t mux);
+  size_t readBurst(uint16_t mux, int16_t *out, size_t n,
+                   volatile bool *ready = NULL);
   void startComparator_SingleEnded(uint8_t channel, int16_t threshold);
+  bool startComparator(uint16_t mux, int16_t lowThreshold,
+                       int16_t highThreshold,
+                       uint16_t mode = ADS1X15_REG_CONFIG_CMODE_TRAD,
+                       uint16_t polarity = ADS1X15_REG_CONFIG_CPOL_ACTVLOW,
+                       uint16_t latch = ADS1X15_REG_CONFIG_CLAT_LATCH,
+                       uint16_t queue = ADS1X15_REG_CONFIG_CQUE_1CONV);
+  bool startComparatorVolts(
+      uint16_t mux, float lowVolts, float highVolts,
+      uint16_t mode = ADS1X15_REG_CONFIG_CMODE_TRAD,
+      uint16_t polarity = ADS1X15_REG_CONFIG_CPOL_ACTVLOW,
+      uint16_t latch = ADS1X15_REG_CONFIG_CLAT_LATCH,
+      uint16_t queue = ADS1X15_REG_CONFIG_CQUE_1CONV);
+  void setAlertCallback(adsAlertCallback_t callback);
+  bool serviceAlert();
   int16_t getLastConversionResults();
+  adsStatus_t getLastConversionResults(int16_t *counts);
   float computeVolts(int16_t counts);
+  int16_t computeCounts(float volts);
+  float computeVolts(int16_t counts, adsGain_t gain);
+  void computeVolts(const int16_t *counts, float *volts, size_t n);
+  int32_t computeMicrovolts(int16_t counts);
+  int32_t computeMicrovolts(int16_t counts, adsGain_t gain);
+  void computeMicrovolts(const int16_t *counts, int32_t *microvolts, size_t n);
   void setGain(adsGain_t gain);
   adsGain_t getGain();
   void setDataRate(uint16_t rate);
   uint16_t getDataRate();
+  uint8_t getResolution();
+  void setConversionTimeout(uint16_t timeout_ms);
+  uint16_t getConversionTimeout();
+  uint32_t getConversionDelay();
 
   void startADCReading(uint16_t mux, bool continuous);
+  void startAsync(adsConversion_t *conv, uint16_t mux,
+                  adsConversionCallback_t callback = NULL);
+  adsConvState_t pollAsync(adsConversion_t *conv, bool dataReady = false);
 
   bool conversionComplete();
+  bool waitForConversion();
+  bool conversionTimedOut();
+
+  bool planScan(adsScanTarget_t *targets, uint8_t count,
+                adsScanEntry_t *table, uint8_t size, uint8_t *length,
+                float *load = NULL);
+  static int16_t interpolateSample(const adsSample_t *before,
+                                   const adsSample_t *after,
+                                   uint32_t timestamp);
+
+  void dataReadyISR();
+
+  adsStatus_t getStatus();
+  void clearStatus();
+  void setWatchdog(bool enable);
+  void setCircuitBreaker(uint8_t threshold, uint16_t cooldown_ms);
+  bool circuitOpen();
+  uint8_t getConsecutiveFailures();
+  uint32_t getRecoveries();
+  bool recover();
+#ifdef ARDUINO
+  void setBusClearPins(int8_t scl, int8_t sda);
+#endif
+
+  uint32_t getSavedTransactions();
+  void setStats(adsStats_t *stats);
+  void setTrace(adsTrace_t *trace);
+#ifdef ARDUINO
+  void dumpTrace(Print &out);
+#endif
 
 private:
-  void writeRegister(uint8_t reg, uint16_t value);
-  uint16_t readRegister(uint8_t reg);
+  // Scans and streams keep their own state, but drive the chip directly
+  friend class Adafruit_ADS1X15_Scan;
+  friend class Adafruit_ADS1X15_Stream;
+
+  void startConversion(uint16_t mux, adsGain_t gain, uint16_t rate,
+                       bool continuous);
+  uint8_t readyEdges(uint32_t *timestamp);
+  void powerDown();
+  void recordLatency();
+  void traceRegister(uint8_t reg, uint16_t value, uint8_t flags);
+  uint32_t conversionDelay(uint16_t rate);
+  uint16_t gainScale(adsGain_t gain);
+  bool startRead();
+  adsStatus_t finishRead();
+  bool busAvailable();
+  void recordFailure(adsStatus_t status);
+  void recordHealthy();
+#ifdef ARDUINO
+  void clearBus();
+#endif
+  bool writeRegister(uint8_t reg, uint16_t value);
+  void writeRegisterCached(uint8_t reg, uint16_t value);
+  void invalidateRegisterCache();
   uint8_t buffer[3];
-};
 
-/**************************************************************************/
-/*!
-    @brief  Sensor driver for the Adafruit ADS1015 ADC breakout.
-*/
-/**************************************************************************/
-class Adafruit_ADS1015 : public Adafruit_ADS1X15 {
-public:
-  Adafruit_ADS1015();
+protected:
+  int16_t readConversion();
+  int16_t readCounts();
+  uint16_t readRegister(uint8_t reg);
 };
 
 /**************************************************************************/
 /*!
-    @brief  Sensor driver for the Adafruit ADS1115 ADC breakout.
+    @brief  Sensor driver specialised at compile time for one chip. The
+            resolution and data rate table come from the Traits class, and
+            passing the other chip's data rate enum to setDataRate() does
+            not compile.
 */
 /**************************************************************************/
-class Adafruit_ADS1115 : public Adafruit_ADS1X15 {
+template <class Traits>
+class Adafruit_ADS1X15_Variant : public Adafruit_ADS1X15 {
 public:
-  Adafruit_ADS1115();
+  /*!
+      @brief  Instantiates a new driver w/appropriate properties
+  */
+  Adafruit_ADS1X15_Variant() {
+    m_bitShift = Traits::bitShift;
+    m_sps = Traits::spsTable;
+    setGain(GAIN_TWOTHIRDS); /* +/- 6.144V range (limited to VDD +0.3V max!) */
+    m_dataRate = Traits::defaultRate;
+  }
+
+  using Adafruit_ADS1X15::setDataRate;
+
+  /*!
+      @brief  Sets the data rate
+      @param rate the data rate to use
+  */
+  void setDataRate(typename Traits::rate_t rate) {
+    Adafruit_ADS1X15::setDataRate(rate);
+  }
+
+  /*!
+      @brief  Rejects the other chip's data rates at compile time
+      @param rate the data rate to use
+  */
+  void setDataRate(typename Traits::other_rate_t rate) = delete;
 };
 
+/** Sensor driver for the Adafruit ADS1015 ADC breakout. */
+typedef Adafruit_ADS1X15_Variant<ADS1015_Traits> Adafruit_ADS1015;
+
+/** Sensor driver for the Adafruit ADS1115 ADC breakout. */
+typedef Adafruit_ADS1X15_Variant<ADS1115_Traits> Adafruit_ADS1115;
+
 #endif
@@ -0,0 +1,241 @@
+/**************************************************************************/
+/*!
+    @file     Adafruit_ADS1X15_BlockStats.cpp
+
+    Integer statistics over blocks of raw ADS1X15 conversions.
+
+    BSD license, all text here must be included in any redistribution
+*/
+/**************************************************************************/
+#include "Adafruit_ADS1X15_BlockStats.h"
+
+/**************************************************************************/
+/*!
+    @brief  Instantiates an empty block
+*/
+/**************************************************************************/
+Adafruit_ADS1X15_BlockStats::Adafruit_ADS1X15_BlockStats() { reset(); }
+
+/**************************************************************************/
+/*!
+    @brief  Empties the block, ready for the next window
+*/
+/**************************************************************************/
+void Adafruit_ADS1X15_BlockStats::reset() {
+  m_min = INT16_MAX;
+  m_max = INT16_MIN;
+  m_count = 0;
+  m_sum = 0;
+  m_sumSquares = 0;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Adds a buffer of samples, e.g. from readBurst()
+
+    @param counts the conversion results
+    @param n number of results
+*/
+/**************************************************************************/
+void Adafruit_ADS1X15_BlockStats::add(const int16_t *counts, size_t n) {
+  int16_t lo = m_min;
+  int16_t hi = m_max;
+  uint64_t squares = m_sumSquares;
+  m_count += n;
+
+  while (n > 0) {
+    // A 32-bit sum of 65536 samples can't overflow
+    size_t chunk = (n > 65536UL) ? 65536UL : n;
+    n -= chunk;
+    int32_t sum = 0;
+
+    // Four at a time. Two squares always fit a uint32_t, so each pair
+    // costs one 64-bit add.
+    for (; chunk >= 4; chunk -= 4, counts += 4) {
+      int32_t a = counts[0];
+      int32_t b = counts[1];
+      int32_t c = counts[2];
+      int32_t d = counts[3];
+      sum += a + b + c + d;
+      squares += (uint32_t)(a * a) + (uint32_t)(b * b);
+      squares += (uint32_t)(c * c) + (uint32_t)(d * d);
+      if (a < lo) {
+        lo = a;
+      }
+      if (a > hi) {
+        hi = a;
+      }
+      if (b < lo) {
+        lo = b;
+      }
+      if (b > hi) {
+        hi = b;
+      }
+      if (c < lo) {
+        lo = c;
+      }
+      if (c > hi) {
+        hi = c;
+      }
+      if (d < lo) {
+        lo = d;
+      }
+      if (d > hi) {
+        hi = d;
+      }
+    }
+    for (; chunk > 0; chunk--, counts++) {
+      int32_t a = *counts;
+      sum += a;
+      squares += (uint32_t)(a * a);
+      if (a < lo) {
+        lo = a;
+      }
+      if (a > hi) {
+        hi = a;
+      }
+    }
+    m_sum += sum;
+  }
+
+  m_min = lo;
+  m_max = hi;
+  m_sumSquares = squares;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gets the number of samples in the block
+
+    @return number of samples added since reset()
+*/
+/**************************************************************************/
+uint32_t Adafruit_ADS1X15_BlockStats::getCount() { return m_count; }
+
+/**************************************************************************/
+/*!
+    @brief  Gets the lowest sample
+
+    @return lowest sample in counts, 0 if the block is empty
+*/
+/**************************************************************************/
+int16_t Adafruit_ADS1X15_BlockStats::getMin() {
+  return (m_count == 0) ? 0 : m_min;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gets the highest sample
+
+    @return highest sample in counts, 0 if the block is empty
+*/
+/**************************************************************************/
+int16_t Adafruit_ADS1X15_BlockStats::getMax() {
+  return (m_count == 0) ? 0 : m_max;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gets the difference between the highest and lowest samples
+
+    @return peak-to-peak in counts
+*/
+/**************************************************************************/
+uint16_t Adafruit_ADS1X15_BlockStats::getPeakToPeak() {
+  return (m_count == 0) ? 0 : (uint16_t)((int32_t)m_max - m_min);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gets the sum of the samples
+
+    @return sum in counts
+*/
+/**************************************************************************/
+int64_t Adafruit_ADS1X15_BlockStats::getSum() { return m_sum; }
+
+/**************************************************************************/
+/*!
+    @brief  Gets the sum of the squared samples
+
+    @return sum of squares in counts squared
+*/
+/**************************************************************************/
+uint64_t Adafruit_ADS1X15_BlockStats::getSumSquares() { return m_sumSquares; }
+
+/**************************************************************************/
+/*!
+    @brief  Gets the mean, the DC level of the block
+
+    @return mean in counts, 0 if the block is empty
+*/
+/**************************************************************************/
+float Adafruit_ADS1X15_BlockStats::getMean() {
+  return (m_count == 0) ? 0.0f : (float)m_sum / m_count;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gets the root mean square of the block
+
+    @return RMS in counts, 0 if the block is empty
+*/
+/**************************************************************************/
+float Adafruit_ADS1X15_BlockStats::getRMS() {
+  return (m_count == 0) ? 0.0f : sqrtf((float)m_sumSquares / m_count);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gets the root mean square with the DC level removed, e.g. the
+            RMS of an AC current riding on a bias voltage
+
+    @return AC RMS in counts, 0 if the block is empty
+*/
+/**************************************************************************/
+float Adafruit_ADS1X15_BlockStats::getACRMS() {
+  if (m_count == 0) {
+    return 0.0f;
+  }
+  // Mean of squares minus the squared mean cancels badly in float when
+  // the DC level is large, so take the squares about the integer part
+  // of the mean exactly, then correct for the fraction that is left
+  int32_t m = (int32_t)(m_sum / (int64_t)m_count);
+  int64_t deviation = (int64_t)m_sumSquares - 2 * (int64_t)m * m_sum +
+                      (int64_t)m_count * m * m;
+  float fraction = getMean() - m;
+  float variance = (float)deviation / m_count - fraction * fraction;
+  return (variance > 0) ? sqrtf(variance) : 0.0f;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Converts the statistics to volts with one multiply each
+
+    @param volts where to store the results
+    @param lsbVolts volts per count, e.g. ads.computeVolts(1, gain) for a
+           scan step with its own gain
+*/
+/**************************************************************************/
+void Adafruit_ADS1X15_BlockStats::getVolts(adsBlockVolts_t *volts,
+                                           float lsbVolts) {
+  volts->min = getMin() * lsbVolts;
+  volts->max = getMax() * lsbVolts;
+  volts->peakToPeak = getPeakToPeak() * lsbVolts;
+  volts->mean = getMean() * lsbVolts;
+  volts->rms = getRMS() * lsbVolts;
+  volts->acRMS = getACRMS() * lsbVolts;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Converts the statistics to volts at the driver's current gain
+
+    @param volts where to store the results
+    @param ads driver the samples were read with
+*/
+/**************************************************************************/
+void Adafruit_ADS1X15_BlockStats::getVolts(adsBlockVolts_t *volts,
+                                           Adafruit_ADS1X15 &ads) {
+  getVolts(volts, ads.computeVolts(1));
+}
@@ -0,0 +1,78 @@
+/**************************************************************************/
+/*!
+    @file     Adafruit_ADS1X15_BlockStats.h
+
+    Integer statistics over blocks of raw ADS1X15 conversions, e.g. for
+    AC current sensing. Samples are accumulated in counts, per sample or
+    a buffer at a time, and only the final results are converted to
+    volts.
+
+    BSD license, all text here must be included in any redistribution
+*/
+/**************************************************************************/
+#ifndef __ADS1X15_BLOCKSTATS_H__
+#define __ADS1X15_BLOCKSTATS_H__
+
+#include "Adafruit_ADS1X15.h"
+
+/** Block statistics in volts, see Adafruit_ADS1X15_BlockStats::getVolts() */
+typedef struct {
+  float min;        ///< Lowest sample
+  float max;        ///< Highest sample
+  float peakToPeak; ///< max - min
+  float mean;       ///< Average, the DC level
+  float rms;        ///< Root mean square
+  float acRMS;      ///< Root mean square with the mean removed
+} adsBlockVolts_t;
+
+/**************************************************************************/
+/*!
+    @brief  Accumulates min, max, sum and sum of squares of conversions in
+            integers. Exact for up to 2^31 samples per block.
+*/
+/**************************************************************************/
+class Adafruit_ADS1X15_BlockStats {
+public:
+  Adafruit_ADS1X15_BlockStats();
+  void reset();
+
+  /*!
+      @brief  Adds one sample, e.g. as each conversion result arrives
+      @param counts the conversion result
+  */
+  void add(int16_t counts) {
+    if (counts < m_min) {
+      m_min = counts;
+    }
+    if (counts > m_max) {
+      m_max = counts;
+    }
+    m_sum += counts;
+    m_sumSquares += (uint32_t)((int32_t)counts * counts);
+    m_count++;
+  }
+
+  void add(const int16_t *counts, size_t n);
+
+  uint32_t getCount();
+  int16_t getMin();
+  int16_t getMax();
+  uint16_t getPeakToPeak();
+  int64_t getSum();
+  uint64_t getSumSquares();
+  float getMean();
+  float getRMS();
+  float getACRMS();
+
+  void getVolts(adsBlockVolts_t *volts, float lsbVolts);
+  void getVolts(adsBlockVolts_t *volts, Adafruit_ADS1X15 &ads);
+
+private:
+  int16_t m_min;         ///< Lowest sample
+  int16_t m_max;         ///< Highest sample
+  uint32_t m_count;      ///< Samples added
+  int64_t m_sum;         ///< Sum of samples
+  uint64_t m_sumSquares; ///< Sum of squared samples
+};
+
+#endif
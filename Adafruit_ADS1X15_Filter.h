@@ -0,0 +1,276 @@
+/**************************************************************************/
+/*!
+    @file     Adafruit_ADS1X15_Filter.h
+
+    Allocation-free integer filter stages that run on each conversion as
+    it arrives, see Adafruit_ADS1X15_Stream::setFilter() and
+    Adafruit_ADS1X15_Scan::setFilters().
+
+    BSD license, all text here must be included in any redistribution
+*/
+/**************************************************************************/
+#ifndef __ADS1X15_FILTER_H__
+#define __ADS1X15_FILTER_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**************************************************************************/
+/*!
+    @brief  One stage of a filter chain. Each stage takes one sample at a
+            time and may or may not produce an output for it, which is
+            how decimating stages lower the output rate.
+*/
+/**************************************************************************/
+class Adafruit_ADS1X15_Filter {
+public:
+  /*!
+      @brief  Instantiates an unchained stage
+  */
+  Adafruit_ADS1X15_Filter() : m_next(NULL) {}
+
+  /*!
+      @brief  Sends this stage's output on to another stage
+      @param next the following stage, or NULL to end the chain here
+  */
+  void chain(Adafruit_ADS1X15_Filter *next) { m_next = next; }
+
+  /*!
+      @brief  Runs a sample through this stage and the rest of the chain
+      @param in input sample in counts
+      @param out receives the output of the last stage, if there is one
+      @return true if the chain produced an output for this sample
+  */
+  bool process(int16_t in, int16_t *out) {
+    int16_t value;
+    if (!push(in, &value)) {
+      return false;
+    }
+    if (m_next != NULL) {
+      return m_next->process(value, out);
+    }
+    *out = value;
+    return true;
+  }
+
+  /*!
+      @brief  Runs a sample through this stage only
+      @param in input sample in counts
+      @param out receives the output, if there is one
+      @return true if the stage produced an output for this sample
+  */
+  virtual bool push(int16_t in, int16_t *out) = 0;
+
+  /*!
+      @brief  Forgets all history, as if no samples had been pushed
+  */
+  virtual void reset() = 0;
+
+protected:
+  Adafruit_ADS1X15_Filter *m_next; ///< Following stage in the chain
+};
+
+/**************************************************************************/
+/*!
+    @brief  Boxcar moving average over the last N samples. The running sum
+            is updated as samples enter and leave, so each sample costs the
+            same whatever N is. Outputs once the window has filled.
+*/
+/**************************************************************************/
+template <uint8_t N>
+class Adafruit_ADS1X15_MovingAverage : public Adafruit_ADS1X15_Filter {
+  static_assert(N > 0, "window must hold at least one sample");
+
+public:
+  /*!
+      @brief  Instantiates an empty window
+  */
+  Adafruit_ADS1X15_MovingAverage() { reset(); }
+
+  /*!
+      @brief  Adds a sample to the window
+      @param in input sample in counts
+      @param out receives the window average, rounded to the nearest count
+      @return true once the window is full
+  */
+  bool push(int16_t in, int16_t *out) override {
+    m_sum += in - m_window[m_index];
+    m_window[m_index] = in;
+    if (++m_index >= N) {
+      m_index = 0;
+    }
+    if (m_fill < N) {
+      m_fill++;
+      if (m_fill < N) {
+        return false;
+      }
+    }
+    int32_t half = (m_sum < 0) ? -(int32_t)(N / 2) : (int32_t)(N / 2);
+    *out = (m_sum + half) / (int32_t)N;
+    return true;
+  }
+
+  /*!
+      @brief  Empties the window
+  */
+  void reset() override {
+    for (uint8_t i = 0; i < N; i++) {
+      m_window[i] = 0;
+    }
+    m_sum = 0;
+    m_index = 0;
+    m_fill = 0;
+  }
+
+private:
+  int16_t m_window[N]; ///< Last N samples
+  int32_t m_sum;       ///< Sum of m_window
+  uint8_t m_index;     ///< Oldest sample in m_window
+  uint8_t m_fill;      ///< Samples in m_window, up to N
+};
+
+/**************************************************************************/
+/*!
+    @brief  CIC decimator: ORDER integrators at the input rate, then ORDER
+            combs at 1/R of it, for one output every R samples. The
+            integrators are allowed to wrap; the CIC structure guarantees
+            the final result is still exact. The output is normalised
+            back to counts by dividing by the filter gain R^ORDER.
+*/
+/**************************************************************************/
+template <uint8_t R, uint8_t ORDER = 1>
+class Adafruit_ADS1X15_Decimator : public Adafruit_ADS1X15_Filter {
+  static_assert(R > 0 && ORDER > 0 && ORDER <= 4, "invalid R or ORDER");
+
+  /*!
+      @brief  Computes R^n
+      @param n exponent
+      @return R^n
+  */
+  static constexpr uint32_t gain(uint8_t n) {
+    return n == 0 ? 1 : R * gain(n - 1);
+  }
+
+public:
+  /*!
+      @brief  Instantiates a decimator with empty state
+  */
+  Adafruit_ADS1X15_Decimator() {
+    // Keeps 16-bit samples times the filter gain within 32 bits
+    static_assert(gain(ORDER) <= 65536, "R^ORDER must be at most 65536");
+    reset();
+  }
+
+  /*!
+      @brief  Adds a sample
+      @param in input sample in counts
+      @param out receives the decimated output, rounded to the nearest
+      @return true for every R-th sample
+  */
+  bool push(int16_t in, int16_t *out) override {
+    uint32_t acc = (uint32_t)(int32_t)in;
+    for (uint8_t i = 0; i < ORDER; i++) {
+      m_integ[i] += acc;
+      acc = m_integ[i];
+    }
+    if (++m_phase < R) {
+      return false;
+    }
+    m_phase = 0;
+    for (uint8_t i = 0; i < ORDER; i++) {
+      uint32_t prev = m_comb[i];
+      m_comb[i] = acc;
+      acc -= prev;
+    }
+    // Offset the sum by 32768 counts so it can be rounded and divided
+    // unsigned in 32 bits, without libgcc's slow 64-bit division on AVR.
+    // 65535 counts times R^ORDER, plus the rounding, still fits. Halves
+    // round away from zero, so below the offset they round down.
+    const uint32_t offset = 32768UL * gain(ORDER);
+    uint32_t biased = acc + offset;
+    uint32_t half = (biased < offset) ? (gain(ORDER) - 1) / 2 : gain(ORDER) / 2;
+    *out = (int16_t)((int32_t)((biased + half) / gain(ORDER)) - 32768);
+    return true;
+  }
+
+  /*!
+      @brief  Clears the integrators and combs
+  */
+  void reset() override {
+    for (uint8_t i = 0; i < ORDER; i++) {
+      m_integ[i] = 0;
+      m_comb[i] = 0;
+    }
+    m_phase = 0;
+  }
+
+private:
+  uint32_t m_integ[ORDER]; ///< Integrator state, wraps by design
+  uint32_t m_comb[ORDER];  ///< Comb delay line at the output rate
+  uint8_t m_phase;         ///< Samples since the last output
+};
+
+/**************************************************************************/
+/*!
+    @brief  Median of the last K samples, for rejecting single-sample
+            spikes. K is small and odd, so the window is simply sorted.
+            Outputs once the window has filled.
+*/
+/**************************************************************************/
+template <uint8_t K>
+class Adafruit_ADS1X15_Median : public Adafruit_ADS1X15_Filter {
+  static_assert(K % 2 == 1 && K <= 15, "K must be odd and at most 15");
+
+public:
+  /*!
+      @brief  Instantiates an empty window
+  */
+  Adafruit_ADS1X15_Median() { reset(); }
+
+  /*!
+      @brief  Adds a sample to the window
+      @param in input sample in counts
+      @param out receives the window median
+      @return true once the window is full
+  */
+  bool push(int16_t in, int16_t *out) override {
+    m_window[m_index] = in;
+    if (++m_index >= K) {
+      m_index = 0;
+    }
+    if (m_fill < K) {
+      m_fill++;
+      if (m_fill < K) {
+        return false;
+      }
+    }
+
+    int16_t sorted[K];
+    for (uint8_t i = 0; i < K; i++) {
+      int16_t v = m_window[i];
+      uint8_t j = i;
+      while (j > 0 && sorted[j - 1] > v) {
+        sorted[j] = sorted[j - 1];
+        j--;
+      }
+      sorted[j] = v;
+    }
+    *out = sorted[K / 2];
+    return true;
+  }
+
+  /*!
+      @brief  Empties the window
+  */
+  void reset() override {
+    m_index = 0;
+    m_fill = 0;
+  }
+
+private:
+  int16_t m_window[K]; ///< Last K samples
+  uint8_t m_index;     ///< Oldest sample in m_window
+  uint8_t m_fill;      ///< Samples in m_window, up to K
+};
+
+#endif
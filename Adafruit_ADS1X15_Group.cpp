@@ -0,0 +1,166 @@
+/**************************************************************************/
+/*!
+    @file     Adafruit_ADS1X15_Group.cpp
+
+    Round-robin sampling across several ADS1X15 chips.
+
+    BSD license, all text here must be included in any redistribution
+*/
+/**************************************************************************/
+#include "Adafruit_ADS1X15_Group.h"
+
+/**************************************************************************/
+/*!
+    @brief  Instantiates an empty group
+*/
+/**************************************************************************/
+Adafruit_ADS1X15_Group::Adafruit_ADS1X15_Group() {
+  m_count = 0;
+  m_pending = 0;
+  m_timedOut = 0;
+  m_failed = 0;
+  m_results = NULL;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Adds a chip to the group. begin() must already have been
+            called on it; chips may be on different I2C buses.
+
+    @param ads the chip to add
+
+    @return true if added, false if the group is full
+*/
+/**************************************************************************/
+bool Adafruit_ADS1X15_Group::add(Adafruit_ADS1X15 *ads) {
+  if (ads == NULL || m_count >= ADS1X15_GROUP_MAX) {
+    return false;
+  }
+  m_devices[m_count++] = ads;
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gets the number of chips in the group
+
+    @return the number of chips
+*/
+/**************************************************************************/
+uint8_t Adafruit_ADS1X15_Group::size() { return m_count; }
+
+/**************************************************************************/
+/*!
+    @brief  Gets a chip in the group
+
+    @param index position the chip was added at
+
+    @return the chip, or NULL if index is out of range
+*/
+/**************************************************************************/
+Adafruit_ADS1X15 *Adafruit_ADS1X15_Group::get(uint8_t index) {
+  return (index < m_count) ? m_devices[index] : NULL;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Starts a single-shot conversion with the same mux setting on
+            every chip. Each chip uses its own gain and data rate.
+
+    @param mux mux field value
+    @param results array of size() entries the readings are stored in
+*/
+/**************************************************************************/
+void Adafruit_ADS1X15_Group::start(uint16_t mux, int16_t *results) {
+  m_results = results;
+  m_pending = 0;
+  m_timedOut = 0;
+  m_failed = 0;
+  for (uint8_t i = 0; i < m_count; i++) {
+    m_devices[i]->startADCReading(mux, /*continuous=*/false);
+    m_pending |= (1 << i);
+  }
+  m_start = micros();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Collects the result of every chip that has finished since the
+            last call. Chips are only polled once their nominal conversion
+            time has passed.
+
+    @return true once every chip's result has been collected (or the chip
+            timed out or could not be read, in which case its result is 0
+            and getFailed() has its bit set)
+*/
+/**************************************************************************/
+bool Adafruit_ADS1X15_Group::update() {
+  if (m_pending == 0) {
+    return true;
+  }
+
+  uint32_t elapsed = micros() - m_start;
+  for (uint8_t i = 0; i < m_count; i++) {
+    if (!(m_pending & (1 << i))) {
+      continue;
+    }
+
+    Adafruit_ADS1X15 *ads = m_devices[i];
+    uint32_t wait = ads->getConversionDelay();
+    if (elapsed < wait - wait / 10) {
+      continue;
+    }
+
+    if (ads->conversionComplete()) {
+      if (ads->getLastConversionResults(&m_results[i]) != ADS1X15_OK) {
+        m_failed |= (1 << i);
+      }
+      m_pending &= ~(1 << i);
+    } else if (elapsed >= ads->getConversionTimeout() * 1000UL) {
+      m_results[i] = 0;
+      m_timedOut |= (1 << i);
+      m_pending &= ~(1 << i);
+    }
+  }
+
+  return m_pending == 0;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Returns true while any chip started by start() is still
+            converting.
+
+    @return True if results are outstanding, false otherwise.
+*/
+/**************************************************************************/
+bool Adafruit_ADS1X15_Group::busy() { return m_pending != 0; }
+
+/**************************************************************************/
+/*!
+    @brief  Reads the same mux setting on every chip, with the
+            conversions running in parallel.
+
+    @param mux mux field value
+    @param results array of size() entries the readings are stored in
+
+    @return true if every chip returned a result, false if any timed out
+            or could not be read
+*/
+/**************************************************************************/
+bool Adafruit_ADS1X15_Group::readAll(uint16_t mux, int16_t *results) {
+  start(mux, results);
+  while (!update())
+    ;
+  return getFailed() == 0;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gets the chips with no valid result from the last start(),
+            because their conversion timed out or reading it failed
+
+    @return a bitmask with bit i set for the chip at index i
+*/
+/**************************************************************************/
+uint8_t Adafruit_ADS1X15_Group::getFailed() { return m_timedOut | m_failed; }
@@ -0,0 +1,47 @@
+/**************************************************************************/
+/*!
+    @file     Adafruit_ADS1X15_Group.h
+
+    Round-robin sampling across several ADS1X15 chips, so their
+    conversions overlap in time instead of running one after another.
+
+    BSD license, all text here must be included in any redistribution
+*/
+/**************************************************************************/
+#ifndef __ADS1X15_GROUP_H__
+#define __ADS1X15_GROUP_H__
+
+#include "Adafruit_ADS1X15.h"
+
+#define ADS1X15_GROUP_MAX (4) ///< One chip per ADDR pin setting
+
+/**************************************************************************/
+/*!
+    @brief  Triggers a conversion on every chip in the group, then
+            collects each result as soon as that chip is done.
+*/
+/**************************************************************************/
+class Adafruit_ADS1X15_Group {
+public:
+  Adafruit_ADS1X15_Group();
+  bool add(Adafruit_ADS1X15 *ads);
+  uint8_t size();
+  Adafruit_ADS1X15 *get(uint8_t index);
+
+  void start(uint16_t mux, int16_t *results);
+  bool update();
+  bool busy();
+  bool readAll(uint16_t mux, int16_t *results);
+  uint8_t getFailed();
+
+private:
+  Adafruit_ADS1X15 *m_devices[ADS1X15_GROUP_MAX]; ///< Chips in the group
+  uint8_t m_count;                                ///< Number of chips
+  uint8_t m_pending;                              ///< Chips still converting
+  uint8_t m_timedOut;                             ///< Chips that timed out
+  uint8_t m_failed;                               ///< Chips that failed a read
+  int16_t *m_results;                             ///< Result per chip
+  uint32_t m_start;                               ///< micros() at start()
+};
+
+#endif
@@ -0,0 +1,74 @@
+/**************************************************************************/
+/*!
+    @file     Adafruit_ADS1X15_Host.h
+
+    The few Arduino core functions the ADS1X15 driver needs, for building
+    it outside Arduino on a POSIX host. Like the Arduino versions, the
+    counters are 32 bits wide and wrap around.
+
+    BSD license, all text here must be included in any redistribution
+*/
+/**************************************************************************/
+#ifndef __ADS1X15_HOST_H__
+#define __ADS1X15_HOST_H__
+
+#include <math.h>
+#include <sched.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*!
+    @brief  Reads the monotonic clock
+    @return microseconds since an arbitrary point
+*/
+static inline uint64_t ads1x15HostMicros() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+/*!
+    @brief  Gets the time in microseconds
+    @return microseconds, wrapping at 32 bits
+*/
+static inline uint32_t micros() { return (uint32_t)ads1x15HostMicros(); }
+
+/*!
+    @brief  Gets the time in milliseconds
+    @return milliseconds, wrapping at 32 bits
+*/
+static inline uint32_t millis() {
+  return (uint32_t)(ads1x15HostMicros() / 1000);
+}
+
+/*!
+    @brief  Sleeps for at least some microseconds
+    @param us microseconds to sleep
+*/
+static inline void delayMicroseconds(uint32_t us) {
+  struct timespec ts;
+  ts.tv_sec = us / 1000000UL;
+  ts.tv_nsec = (long)(us % 1000000UL) * 1000L;
+  nanosleep(&ts, NULL);
+}
+
+/*!
+    @brief  Sleeps for at least some milliseconds
+    @param ms milliseconds to sleep
+*/
+static inline void delay(uint32_t ms) {
+  struct timespec ts;
+  ts.tv_sec = ms / 1000UL;
+  ts.tv_nsec = (long)(ms % 1000UL) * 1000000L;
+  nanosleep(&ts, NULL);
+}
+
+/*!
+    @brief  Lets other threads run while busy-waiting
+*/
+static inline void yield() { sched_yield(); }
+
+#endif
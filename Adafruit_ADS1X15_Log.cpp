@@ -0,0 +1,440 @@
+/**************************************************************************/
+/*!
+    @file     Adafruit_ADS1X15_Log.cpp
+
+    Compact framed binary format for logging ADS1X15 readings.
+
+    BSD license, all text here must be included in any redistribution
+*/
+/**************************************************************************/
+#include "Adafruit_ADS1X15_Log.h"
+
+#include <string.h>
+
+/** Header magic */
+static const uint8_t LOG_MAGIC[4] = {'A', 'D', 'S', 'L'};
+
+/** Header length, including the checksum */
+#define LOG_HEADER_LEN (10)
+
+/**************************************************************************/
+/*!
+    @brief  XORs a run of bytes together
+
+    @param data bytes to check
+    @param len number of bytes
+
+    @return the checksum
+*/
+/**************************************************************************/
+static uint8_t logChecksum(const uint8_t *data, size_t len) {
+  uint8_t sum = 0;
+  for (size_t i = 0; i < len; i++) {
+    sum ^= data[i];
+  }
+  return sum;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Maps a signed delta to an unsigned value, small magnitudes to
+            small values, so it encodes as a short varint
+
+    @param delta difference between consecutive readings
+
+    @return the zigzag encoded delta
+*/
+/**************************************************************************/
+static uint32_t logZigzag(int32_t delta) {
+  return ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Converts logged counts to volts, exactly as computeVolts()
+            does on the device
+
+    @param header header of the log the reading came from
+    @param counts the reading in raw counts
+
+    @return the reading in volts
+*/
+/**************************************************************************/
+float adsLogVolts(const adsLogHeader_t *header, int16_t counts) {
+  // see data sheet Table 3
+  static const float fsRange[] = {6.144f, 4.096f, 2.048f,
+                                  1.024f, 0.512f, 0.256f};
+  if (header->gain >= sizeof(fsRange) / sizeof(fsRange[0])) {
+    return 0.0f;
+  }
+  uint8_t bitShift = 16 - header->bits;
+  return counts * (fsRange[header->gain] / (32768 >> bitShift));
+}
+
+/**************************************************************************/
+/*!
+    @brief  Instantiates an encoder over buffers owned by the subclass
+
+    @param writer function the encoded bytes are passed to
+    @param context passed to writer, e.g. a Print or FILE pointer
+    @param block room for blockLen readings per channel
+    @param fill one counter per channel, zeroed by the subclass
+    @param out room to encode a block of blockLen readings
+    @param channels number of channels buffered
+    @param blockLen readings per block, at most ADS1X15_LOG_MAX_BLOCK
+*/
+/**************************************************************************/
+Adafruit_ADS1X15_LogEncoderBase::Adafruit_ADS1X15_LogEncoderBase(
+    adsLogWriter_t writer, void *context, int16_t *block, uint8_t *fill,
+    uint8_t *out, uint8_t channels, uint8_t blockLen) {
+  m_writer = writer;
+  m_context = context;
+  m_block = block;
+  m_fill = fill;
+  m_out = out;
+  m_channels = channels;
+  m_blockLen = blockLen;
+  m_pack12 = false;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Writes out any pending readings, then a header describing the
+            readings that follow
+
+    @param header the ADC settings, see adsLogHeader_t
+*/
+/**************************************************************************/
+void Adafruit_ADS1X15_LogEncoderBase::begin(const adsLogHeader_t *header) {
+  flush();
+
+  uint8_t out[LOG_HEADER_LEN];
+  memcpy(out, LOG_MAGIC, sizeof(LOG_MAGIC));
+  out[4] = ADS1X15_LOG_VERSION;
+  out[5] = header->bits;
+  out[6] = header->gain;
+  out[7] = header->rate;
+  out[8] = header->channels;
+  out[9] = logChecksum(out, 9);
+  m_writer(m_context, out, sizeof(out));
+
+  m_pack12 = (header->bits <= 12);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Adds a reading. A block is written once a block's worth of
+            readings of the channel are pending.
+
+    @param channel channel number, below the CHANNELS the encoder buffers
+    @param counts the reading in raw counts
+
+    @return true if the reading was accepted
+*/
+/**************************************************************************/
+bool Adafruit_ADS1X15_LogEncoderBase::push(uint8_t channel, int16_t counts) {
+  if (channel >= m_channels) {
+    return false;
+  }
+  m_block[channel * m_blockLen + m_fill[channel]++] = counts;
+  if (m_fill[channel] >= m_blockLen) {
+    writeBlock(channel);
+  }
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Writes out all pending readings as short blocks
+*/
+/**************************************************************************/
+void Adafruit_ADS1X15_LogEncoderBase::flush() {
+  for (uint8_t channel = 0; channel < m_channels; channel++) {
+    if (m_fill[channel] != 0) {
+      writeBlock(channel);
+    }
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Encodes a channel's pending readings as one block
+
+    @param channel channel number
+*/
+/**************************************************************************/
+void Adafruit_ADS1X15_LogEncoderBase::writeBlock(uint8_t channel) {
+  const int16_t *samples = &m_block[channel * m_blockLen];
+  uint8_t n = m_fill[channel];
+  m_fill[channel] = 0;
+
+  // Delta encoding wins for slowly changing signals, packing for noisy
+  // ones, so size both up
+  size_t deltaLen = 2;
+  bool fits12 = m_pack12;
+  for (uint8_t i = 0; i < n; i++) {
+    if (samples[i] < -2048 || samples[i] > 2047) {
+      fits12 = false;
+    }
+    if (i > 0) {
+      uint32_t z = logZigzag((int32_t)samples[i] - samples[i - 1]);
+      deltaLen += (z < 0x80) ? 1 : (z < 0x4000) ? 2 : 3;
+    }
+  }
+  bool pack = fits12 && ((size_t)(n * 3 + 1) / 2 <= deltaLen);
+
+  uint8_t *out = m_out;
+  size_t pos = 0;
+  out[pos++] = ADS1X15_LOG_SYNC;
+  out[pos++] = channel;
+  out[pos++] = pack ? ADS1X15_LOG_PACK12 : ADS1X15_LOG_DELTA;
+  out[pos++] = n;
+
+  if (pack) {
+    for (uint8_t i = 0; i < n; i += 2) {
+      uint16_t a = samples[i] & 0xFFF;
+      out[pos++] = a >> 4;
+      if (i + 1 < n) {
+        uint16_t b = samples[i + 1] & 0xFFF;
+        out[pos++] = ((a & 0xF) << 4) | (b >> 8);
+        out[pos++] = b & 0xFF;
+      } else {
+        out[pos++] = (a & 0xF) << 4;
+      }
+    }
+  } else {
+    out[pos++] = (uint16_t)samples[0] >> 8;
+    out[pos++] = (uint16_t)samples[0] & 0xFF;
+    for (uint8_t i = 1; i < n; i++) {
+      uint32_t z = logZigzag((int32_t)samples[i] - samples[i - 1]);
+      while (z >= 0x80) {
+        out[pos++] = (z & 0x7F) | 0x80;
+        z >>= 7;
+      }
+      out[pos++] = z;
+    }
+  }
+
+  out[pos] = logChecksum(out, pos);
+  pos++;
+  m_writer(m_context, out, pos);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Instantiates a decoder
+
+    @param reader function each decoded reading is passed to
+    @param context passed to reader
+*/
+/**************************************************************************/
+Adafruit_ADS1X15_LogDecoder::Adafruit_ADS1X15_LogDecoder(adsLogReader_t reader,
+                                                         void *context) {
+  m_reader = reader;
+  m_context = context;
+  m_hasHeader = false;
+  m_errors = 0;
+  m_len = 0;
+  m_need = 0;
+  m_varints = 0;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Parses the next byte of the stream. Bytes outside a header or
+            block are skipped, so decoding can start mid-stream once the
+            next header has been seen.
+
+    @param byte the next byte
+
+    @return false if the byte showed a header or block to be corrupt
+*/
+/**************************************************************************/
+bool Adafruit_ADS1X15_LogDecoder::feed(uint8_t byte) {
+  if (parse(byte)) {
+    return true;
+  }
+
+  // The corrupt frame may have swallowed the start of the next one, e.g.
+  // after a dropped byte, so parse it again from its second byte. Bytes
+  // go back into m_frame no faster than they are taken out, so this
+  // works in place.
+  m_errors++;
+  uint16_t len = m_len;
+  uint16_t pos = 1;
+  m_len = 0;
+  while (pos < len) {
+    if (!parse(m_frame[pos++])) {
+      // Rescan this one too, ahead of the bytes still to be parsed
+      m_errors++;
+      memmove(&m_frame[m_len], &m_frame[pos], len - pos);
+      len = m_len + (len - pos);
+      pos = 1;
+      m_len = 0;
+    }
+  }
+  return false;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Adds a byte to the frame being parsed, decoding the frame once
+            it is complete
+
+    @param byte the next byte
+
+    @return false if the frame in m_frame, which ends with this byte, is
+            corrupt
+*/
+/**************************************************************************/
+bool Adafruit_ADS1X15_LogDecoder::parse(uint8_t byte) {
+  if (m_len == 0) {
+    // Blocks are only meaningful once a header has given the settings
+    if (byte == LOG_MAGIC[0] || (byte == ADS1X15_LOG_SYNC && m_hasHeader)) {
+      m_frame[m_len++] = byte;
+      m_need = (byte == LOG_MAGIC[0]) ? LOG_HEADER_LEN : 0;
+      m_varints = 0;
+    }
+    return true;
+  }
+
+  m_frame[m_len++] = byte;
+
+  if (m_frame[0] == LOG_MAGIC[0]) {
+    if (m_len <= sizeof(LOG_MAGIC)) {
+      if (byte != LOG_MAGIC[m_len - 1]) {
+        // Not a header after all, but this byte may start one
+        m_len = 0;
+        return parse(byte);
+      }
+      return true;
+    }
+    if (m_len < m_need) {
+      return true;
+    }
+    if (logChecksum(m_frame, m_len - 1) != byte ||
+        m_frame[4] != ADS1X15_LOG_VERSION ||
+        (m_frame[5] != 12 && m_frame[5] != 16)) {
+      return false;
+    }
+    m_header.bits = m_frame[5];
+    m_header.gain = m_frame[6];
+    m_header.rate = m_frame[7];
+    m_header.channels = m_frame[8];
+    m_hasHeader = true;
+    m_len = 0;
+    return true;
+  }
+
+  uint8_t type = (m_len > 2) ? m_frame[2] : 0;
+  uint8_t n = (m_len > 3) ? m_frame[3] : 0;
+  if (m_len == 4) {
+    if (n == 0 || n > ADS1X15_LOG_MAX_BLOCK) {
+      return false;
+    }
+    if (type == ADS1X15_LOG_PACK12) {
+      m_need = 4 + (n * 3 + 1) / 2 + 1;
+    } else if (type != ADS1X15_LOG_DELTA) {
+      return false;
+    }
+    return true;
+  }
+  if (m_len < 4) {
+    return true;
+  }
+
+  if (m_need == 0) {
+    // DELTA block: its length is known once all the varints have ended
+    if (m_len > 6 && !(byte & 0x80)) {
+      m_varints++;
+    }
+    if (m_len >= 6 && m_varints == n - 1) {
+      m_need = m_len + 1;
+    } else if (m_len >= sizeof(m_frame) - 1) {
+      return false;
+    }
+    return true;
+  }
+
+  if (m_len < m_need) {
+    return true;
+  }
+  if (logChecksum(m_frame, m_len - 1) != byte) {
+    return false;
+  }
+  decodeBlock();
+  m_len = 0;
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Returns true once a header has been decoded.
+
+    @return True if header() is valid, false otherwise.
+*/
+/**************************************************************************/
+bool Adafruit_ADS1X15_LogDecoder::hasHeader() { return m_hasHeader; }
+
+/**************************************************************************/
+/*!
+    @brief  Gets the most recent header, for adsLogVolts()
+
+    @return the header
+*/
+/**************************************************************************/
+const adsLogHeader_t *Adafruit_ADS1X15_LogDecoder::header() {
+  return &m_header;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gets the number of corrupt headers and blocks skipped
+
+    @return the error count
+*/
+/**************************************************************************/
+uint32_t Adafruit_ADS1X15_LogDecoder::errors() { return m_errors; }
+
+/**************************************************************************/
+/*!
+    @brief  Passes each reading in the complete block in m_frame to the
+            reader callback
+*/
+/**************************************************************************/
+void Adafruit_ADS1X15_LogDecoder::decodeBlock() {
+  uint8_t channel = m_frame[1];
+  uint8_t n = m_frame[3];
+  const uint8_t *p = &m_frame[4];
+
+  if (m_frame[2] == ADS1X15_LOG_PACK12) {
+    for (uint8_t i = 0; i < n; i += 2) {
+      uint16_t a = (p[0] << 4) | (p[1] >> 4);
+      // Shift up and back down to extend the 12-bit sign
+      m_reader(m_context, channel, (int16_t)(a << 4) >> 4);
+      if (i + 1 < n) {
+        uint16_t b = ((p[1] & 0x0F) << 8) | p[2];
+        m_reader(m_context, channel, (int16_t)(b << 4) >> 4);
+        p += 3;
+      } else {
+        p += 2;
+      }
+    }
+    return;
+  }
+
+  int16_t value = (int16_t)((p[0] << 8) | p[1]);
+  p += 2;
+  m_reader(m_context, channel, value);
+  for (uint8_t i = 1; i < n; i++) {
+    uint32_t z = 0;
+    uint8_t shift = 0;
+    do {
+      z |= (uint32_t)(*p & 0x7F) << shift;
+      shift += 7;
+    } while (*p++ & 0x80);
+    int32_t delta = (int32_t)(z >> 1) ^ -(int32_t)(z & 1);
+    value = (int16_t)(value + delta);
+    m_reader(m_context, channel, value);
+  }
+}
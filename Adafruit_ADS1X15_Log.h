@@ -0,0 +1,151 @@
+/**************************************************************************/
+/*!
+    @file     Adafruit_ADS1X15_Log.h
+
+    Compact framed binary format for logging ADS1X15 readings over a
+    serial link or to a file, with a streaming encoder and decoder. This
+    file has no Arduino dependencies so the decoder also builds on a host.
+
+    Stream layout:
+
+    Header: 'A' 'D' 'S' 'L' version bits gain rate channels checksum
+
+    Block:  0xA5 channel type count payload checksum
+
+    The type is ADS1X15_LOG_PACK12 (count readings as 12-bit two's
+    complement, two per three bytes) or ADS1X15_LOG_DELTA (first reading
+    as a big-endian int16, then count - 1 zigzag varint deltas). The
+    checksum is the XOR of the preceding bytes of the header or block.
+
+    BSD license, all text here must be included in any redistribution
+*/
+/**************************************************************************/
+#ifndef __ADS1X15_LOG_H__
+#define __ADS1X15_LOG_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define ADS1X15_LOG_VERSION (1) ///< Format version in the header
+#define ADS1X15_LOG_SYNC (0xA5) ///< First byte of every block
+#define ADS1X15_LOG_PACK12 (0)  ///< Block of packed 12-bit readings
+#define ADS1X15_LOG_DELTA (1)   ///< Block of delta-encoded readings
+
+#define ADS1X15_LOG_MAX_BLOCK (64) ///< Largest block the decoder accepts
+
+/** Settings needed to turn logged counts back into volts */
+typedef struct {
+  uint8_t bits;     ///< 12 for the ADS1015, 16 for the ADS1115
+  uint8_t gain;     ///< PGA field, adsGain_t >> 9
+  uint8_t rate;     ///< Data rate field, data rate >> 5
+  uint8_t channels; ///< Number of channels logged
+} adsLogHeader_t;
+
+float adsLogVolts(const adsLogHeader_t *header, int16_t counts);
+
+/** Receives encoded bytes from Adafruit_ADS1X15_LogEncoder */
+typedef void (*adsLogWriter_t)(void *context, const uint8_t *data,
+                               size_t len);
+
+/** Receives readings from Adafruit_ADS1X15_LogDecoder */
+typedef void (*adsLogReader_t)(void *context, uint8_t channel,
+                               int16_t counts);
+
+/**************************************************************************/
+/*!
+    @brief  Writes buffered readings out as blocks, each in whichever
+            encoding is smaller. The buffers are sized by
+            Adafruit_ADS1X15_LogEncoder, so this class has the same layout
+            in every sketch and translation unit that uses it.
+*/
+/**************************************************************************/
+class Adafruit_ADS1X15_LogEncoderBase {
+public:
+  void begin(const adsLogHeader_t *header);
+  bool push(uint8_t channel, int16_t counts);
+  void flush();
+
+protected:
+  Adafruit_ADS1X15_LogEncoderBase(adsLogWriter_t writer, void *context,
+                                  int16_t *block, uint8_t *fill, uint8_t *out,
+                                  uint8_t channels, uint8_t blockLen);
+
+private:
+  void writeBlock(uint8_t channel);
+
+  adsLogWriter_t m_writer; ///< Output function
+  void *m_context;         ///< Passed to m_writer
+  int16_t *m_block;        ///< Pending readings, blockLen per channel
+  uint8_t *m_fill;         ///< Pending readings per channel
+  uint8_t *m_out;          ///< Room to encode one block
+  uint8_t m_channels;      ///< Channels buffered
+  uint8_t m_blockLen;      ///< Readings per block
+  bool m_pack12;           ///< Readings fit in 12 bits
+};
+
+/**************************************************************************/
+/*!
+    @brief  Log encoder buffering BLOCK readings for each of CHANNELS
+            channels. RAM use is about (2 * BLOCK + 1) * CHANNELS + 3 *
+            BLOCK bytes, so size both to what is logged.
+*/
+/**************************************************************************/
+template <uint8_t CHANNELS = 4, uint8_t BLOCK = 16>
+class Adafruit_ADS1X15_LogEncoder : public Adafruit_ADS1X15_LogEncoderBase {
+  static_assert(CHANNELS > 0, "encoder must buffer at least one channel");
+  static_assert(BLOCK > 0 && BLOCK <= ADS1X15_LOG_MAX_BLOCK,
+                "decoder rejects blocks over ADS1X15_LOG_MAX_BLOCK");
+
+public:
+  /*!
+      @brief  Instantiates an encoder
+      @param writer function the encoded bytes are passed to
+      @param context passed to writer, e.g. a Print or FILE pointer
+  */
+  Adafruit_ADS1X15_LogEncoder(adsLogWriter_t writer, void *context = NULL)
+      : Adafruit_ADS1X15_LogEncoderBase(writer, context, &m_block[0][0],
+                                        m_fill, m_out, CHANNELS, BLOCK) {
+    for (uint8_t i = 0; i < CHANNELS; i++) {
+      m_fill[i] = 0;
+    }
+  }
+
+private:
+  int16_t m_block[CHANNELS][BLOCK];       ///< Pending readings
+  uint8_t m_fill[CHANNELS];               ///< Readings in m_block
+  uint8_t m_out[6 + (BLOCK - 1) * 3 + 1]; ///< Block being encoded
+};
+
+/**************************************************************************/
+/*!
+    @brief  Parses an encoded stream a byte at a time, passing each
+            reading to a callback. Corrupt headers and blocks are counted
+            and skipped.
+*/
+/**************************************************************************/
+class Adafruit_ADS1X15_LogDecoder {
+public:
+  Adafruit_ADS1X15_LogDecoder(adsLogReader_t reader, void *context = NULL);
+  bool feed(uint8_t byte);
+  bool hasHeader();
+  const adsLogHeader_t *header();
+  uint32_t errors();
+
+private:
+  bool parse(uint8_t byte);
+  void decodeBlock();
+
+  adsLogReader_t m_reader; ///< Output function
+  void *m_context;         ///< Passed to m_reader
+  adsLogHeader_t m_header; ///< Last header seen
+  bool m_hasHeader;        ///< m_header is valid
+  uint32_t m_errors;       ///< Corrupt frames seen
+
+  /** The header or block being parsed */
+  uint8_t m_frame[6 + (ADS1X15_LOG_MAX_BLOCK - 1) * 3 + 1];
+  uint16_t m_len;    ///< Bytes in m_frame
+  uint16_t m_need;   ///< Frame length or 0
+  uint8_t m_varints; ///< Deltas parsed
+};
+
+#endif
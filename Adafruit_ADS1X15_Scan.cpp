@@ -0,0 +1,276 @@
+/**************************************************************************/
+/*!
+    @file     Adafruit_ADS1X15_Scan.cpp
+
+    Non-blocking scan through a sequence of mux settings on one ADS1X15.
+
+    BSD license, all text here must be included in any redistribution
+*/
+/**************************************************************************/
+#include "Adafruit_ADS1X15_Scan.h"
+
+/**************************************************************************/
+/*!
+    @brief  Instantiates an idle scan
+
+    @param ads the chip to scan, which must outlive this object
+*/
+/**************************************************************************/
+Adafruit_ADS1X15_Scan::Adafruit_ADS1X15_Scan(Adafruit_ADS1X15 *ads) {
+  m_ads = ads;
+  m_seq = NULL;
+  m_results = NULL;
+  m_filters = NULL;
+  m_samples = NULL;
+  m_aligned = NULL;
+  m_skew = 0;
+  m_errors = 0;
+  m_count = 0;
+  m_active = false;
+  m_primed = false;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Starts a non-blocking scan through a sequence of mux settings.
+            Call update() from loop(), or when ALERT/RDY fires, to
+            advance it.
+
+    @param sequence mux and gain to use for each step of the scan
+    @param count number of entries in sequence
+    @param results array of count entries the readings are stored in
+    @param repeat start a new sweep automatically after each one finishes
+*/
+/**************************************************************************/
+void Adafruit_ADS1X15_Scan::start(const adsScanEntry_t *sequence,
+                                  uint8_t count, int16_t *results,
+                                  bool repeat) {
+  m_active = false;
+  if (sequence == NULL || results == NULL || count == 0) {
+    return;
+  }
+
+  m_seq = sequence;
+  m_results = results;
+  m_count = count;
+  m_index = 0;
+  m_repeat = repeat;
+  m_primed = false;
+  m_skew = 0;
+  m_errors = 0;
+  m_active = true;
+
+  startEntry();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Advances the scan started by start(). Stores the result of the
+            current step once it is ready and starts the next one.
+
+    @param dataReady set if ALERT/RDY already signalled the end of the
+           conversion, which skips polling the OS bit
+
+    @return true if a full sweep of results is now available
+*/
+/**************************************************************************/
+bool Adafruit_ADS1X15_Scan::update(bool dataReady) {
+  if (!m_active) {
+    return false;
+  }
+
+  uint32_t timestamp;
+  if (!dataReady) {
+    // Don't spend bus time polling before the conversion can be done
+    uint32_t wait = m_ads->conversionDelay(rate(m_index));
+    uint32_t elapsed = micros() - m_start;
+    if (elapsed < wait - wait / 10) {
+      return false;
+    }
+    if (!m_ads->conversionComplete()) {
+      if (m_ads->m_watchdog && m_ads->busAvailable() &&
+          elapsed >= wait + wait / 10 + ADS1X15_WATCHDOG_SLACK) {
+        // Stuck: recover and convert this step again
+        m_ads->recordFailure(ADS1X15_ERR_TIMEOUT);
+        m_ads->recover();
+        startEntry();
+      }
+      return false;
+    }
+    timestamp = m_ads->m_doneTime;
+  } else if (m_ads->readyEdges(&timestamp) == m_edge) {
+    // Told by the caller, dataReadyISR() did not see the edge
+    timestamp = micros();
+  }
+
+  // Read the result before starting the next step. A fast data rate can
+  // finish the next conversion, and overwrite this result, in less time
+  // than the pointer write and read take on a slow bus.
+  int16_t counts;
+  if (m_ads->getLastConversionResults(&counts) != ADS1X15_OK) {
+    // Convert this step again rather than store a reading that never
+    // arrived
+    m_errors++;
+    startEntry();
+    return false;
+  }
+
+  uint8_t done = m_index;
+  bool swept = false;
+  if (++m_index >= m_count) {
+    m_index = 0;
+    swept = true;
+    m_active = m_repeat;
+  }
+  if (m_active) {
+    startEntry();
+  }
+
+  // A decimating filter only updates the result when it has an output
+  Adafruit_ADS1X15_Filter *filter =
+      (m_filters != NULL) ? m_filters[done] : NULL;
+  if (filter == NULL || filter->process(counts, &counts)) {
+    m_results[done] = counts;
+    if (m_samples != NULL) {
+      recordSample(done, timestamp, counts);
+    }
+  }
+
+  if (swept && m_samples != NULL) {
+    m_skew = m_samples[m_count - 1].timestamp - m_samples[0].timestamp;
+    m_primed = true;
+  }
+
+  return swept;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Stops the scan started by start(). The conversion in progress,
+            if any, is left to finish.
+*/
+/**************************************************************************/
+void Adafruit_ADS1X15_Scan::stop() { m_active = false; }
+
+/**************************************************************************/
+/*!
+    @brief  Returns true while a scan is running.
+
+    @return True if a scan is running, false otherwise.
+*/
+/**************************************************************************/
+bool Adafruit_ADS1X15_Scan::active() { return m_active; }
+
+/**************************************************************************/
+/*!
+    @brief  Sets filter chains to run on the scan results, one per scan
+            entry since each entry is a separate signal. A result is only
+            updated when its filter produces an output.
+
+    @param filters array with one filter (or NULL) per scan entry, or NULL
+           to stop filtering
+*/
+/**************************************************************************/
+void Adafruit_ADS1X15_Scan::setFilters(Adafruit_ADS1X15_Filter **filters) {
+  m_filters = filters;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Sets arrays that receive a timestamped record of each scan
+            result. The timestamp is taken when the result was seen to be
+            ready: the ALERT/RDY edge recorded by dataReadyISR(), or the
+            poll that found the OS bit set.
+
+    @param samples array with one record per scan entry, or NULL
+    @param aligned optional array with one entry per scan entry. After
+           each result it holds that entry's reading interpolated back to
+           the time of the first entry's reading in the same sweep, so a
+           whole sweep can be treated as simultaneous.
+*/
+/**************************************************************************/
+void Adafruit_ADS1X15_Scan::setSamples(adsSample_t *samples,
+                                       int16_t *aligned) {
+  m_samples = samples;
+  m_aligned = aligned;
+  m_primed = false;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gets the time between the first and last readings of the most
+            recent complete sweep. Needs setSamples().
+
+    @return the inter-channel skew in microseconds
+*/
+/**************************************************************************/
+uint32_t Adafruit_ADS1X15_Scan::getSkew() { return m_skew; }
+
+/**************************************************************************/
+/*!
+    @brief  Gets the number of results that could not be read since
+            start(). Each such step is converted again, so a sweep only
+            completes with a good reading for every entry; getStatus() on
+            the driver gives the reason for the latest failure.
+
+    @return the failed read count
+*/
+/**************************************************************************/
+uint32_t Adafruit_ADS1X15_Scan::getErrors() { return m_errors; }
+
+/**************************************************************************/
+/*!
+    @brief  Stores a scan result in the sample records, and its value at
+            the time of the sweep's first reading in the aligned results
+
+    @param index scan entry
+    @param timestamp time the result was ready
+    @param counts the result
+*/
+/**************************************************************************/
+void Adafruit_ADS1X15_Scan::recordSample(uint8_t index, uint32_t timestamp,
+                                         int16_t counts) {
+  adsSample_t sample;
+  sample.timestamp = timestamp;
+  sample.counts = counts;
+  sample.mux = m_seq[index].mux;
+
+  if (m_aligned != NULL) {
+    // The record still holds this entry's reading from the last sweep,
+    // which brackets the first reading of this sweep with the new one
+    if (index == 0 || !m_primed) {
+      m_aligned[index] = counts;
+    } else {
+      m_aligned[index] = Adafruit_ADS1X15::interpolateSample(
+          &m_samples[index], &sample, m_samples[0].timestamp);
+    }
+  }
+  m_samples[index] = sample;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Starts a single-shot conversion for the current scan step
+*/
+/**************************************************************************/
+void Adafruit_ADS1X15_Scan::startEntry() {
+  const adsScanEntry_t &entry = m_seq[m_index];
+  m_ads->startConversion(entry.mux, entry.gain, rate(m_index),
+                         /*continuous=*/false);
+  m_start = micros();
+  m_edge = m_ads->m_readyCount;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gets the data rate of a scan step
+
+    @param index scan step
+
+    @return the step's rate, or the rate set by setDataRate()
+*/
+/**************************************************************************/
+uint16_t Adafruit_ADS1X15_Scan::rate(uint8_t index) {
+  uint16_t rate = m_seq[index].rate;
+  return (rate == ADS1X15_RATE_DEFAULT) ? m_ads->getDataRate() : rate;
+}
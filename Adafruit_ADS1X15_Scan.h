@@ -0,0 +1,59 @@
+/**************************************************************************/
+/*!
+    @file     Adafruit_ADS1X15_Scan.h
+
+    Non-blocking scan through a sequence of mux settings on one ADS1X15.
+    The scan keeps its state in this object rather than in the driver, so
+    drivers that never scan don't pay for it.
+
+    BSD license, all text here must be included in any redistribution
+*/
+/**************************************************************************/
+#ifndef __ADS1X15_SCAN_H__
+#define __ADS1X15_SCAN_H__
+
+#include "Adafruit_ADS1X15.h"
+
+/**************************************************************************/
+/*!
+    @brief  Steps through a sequence of mux, gain and data rate settings,
+            one single-shot conversion per step, without blocking.
+*/
+/**************************************************************************/
+class Adafruit_ADS1X15_Scan {
+public:
+  Adafruit_ADS1X15_Scan(Adafruit_ADS1X15 *ads);
+
+  void start(const adsScanEntry_t *sequence, uint8_t count, int16_t *results,
+             bool repeat = true);
+  bool update(bool dataReady = false);
+  void stop();
+  bool active();
+  void setFilters(Adafruit_ADS1X15_Filter **filters);
+  void setSamples(adsSample_t *samples, int16_t *aligned = NULL);
+  uint32_t getSkew();
+  uint32_t getErrors();
+
+private:
+  void startEntry();
+  uint16_t rate(uint8_t index);
+  void recordSample(uint8_t index, uint32_t timestamp, int16_t counts);
+
+  Adafruit_ADS1X15 *m_ads;             ///< Chip being scanned
+  const adsScanEntry_t *m_seq;         ///< Scan sequence
+  int16_t *m_results;                  ///< Scan results, one per entry
+  Adafruit_ADS1X15_Filter **m_filters; ///< One per scan entry, or NULL
+  adsSample_t *m_samples;              ///< Timestamped results, or NULL
+  int16_t *m_aligned;                  ///< Time-aligned results, or NULL
+  uint32_t m_start;                    ///< micros() at step start
+  uint32_t m_skew;                     ///< First to last result, in us
+  uint32_t m_errors;                   ///< Results that failed to read
+  uint8_t m_count;                     ///< Number of entries in the scan
+  uint8_t m_index;                     ///< Scan entry converting
+  uint8_t m_edge;                      ///< ALERT/RDY edge count at start
+  bool m_repeat;                       ///< Restart after each sweep
+  bool m_active;                       ///< A scan is running
+  bool m_primed;                       ///< m_samples has a sweep
+};
+
+#endif
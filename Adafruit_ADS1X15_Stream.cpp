@@ -0,0 +1,197 @@
+/**************************************************************************/
+/*!
+    @file     Adafruit_ADS1X15_Stream.cpp
+
+    Continuous conversions from one ADS1X15 captured into a ring buffer.
+
+    BSD license, all text here must be included in any redistribution
+*/
+/**************************************************************************/
+#include "Adafruit_ADS1X15_Stream.h"
+
+/**************************************************************************/
+/*!
+    @brief  Instantiates an idle stream
+
+    @param ads the chip to stream from, which must outlive this object
+*/
+/**************************************************************************/
+Adafruit_ADS1X15_Stream::Adafruit_ADS1X15_Stream(Adafruit_ADS1X15 *ads) {
+  m_ads = ads;
+  m_buf = NULL;
+  m_filter = NULL;
+  m_overruns = 0;
+  m_errors = 0;
+  m_mux = 0;
+  m_mask = 0;
+  m_head = 0;
+  m_tail = 0;
+  m_serviced = 0;
+  m_active = false;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Starts streaming continuous conversions into a ring buffer.
+            Call the driver's dataReadyISR() from the ALERT/RDY interrupt,
+            and service() often enough to read each result before the
+            next one replaces it. Drain the buffer with read().
+
+    @param mux mux field value
+    @param buffer ring buffer storage
+    @param size number of entries in buffer, a power of two up to 128
+
+    @return true if the stream was started, false if size is invalid
+*/
+/**************************************************************************/
+bool Adafruit_ADS1X15_Stream::start(uint16_t mux, adsSample_t *buffer,
+                                    uint8_t size) {
+  if (buffer == NULL || size == 0 || size > 128 || (size & (size - 1))) {
+    return false;
+  }
+
+  m_active = false;
+  m_buf = buffer;
+  m_mask = size - 1;
+  m_head = 0;
+  m_tail = 0;
+  m_overruns = 0;
+  m_errors = 0;
+  m_mux = mux & ADS1X15_REG_CONFIG_MUX_MASK;
+  m_serviced = m_ads->m_readyCount;
+  m_active = true;
+
+  m_ads->startADCReading(mux, /*continuous=*/true);
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Stops the stream started by start() and powers down the ADC.
+            Samples already in the buffer can still be read.
+*/
+/**************************************************************************/
+void Adafruit_ADS1X15_Stream::stop() {
+  m_active = false;
+  m_ads->powerDown();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Reads the conversion flagged by dataReadyISR(), if any, into
+            the buffer. This is the only producer for the buffer, so it
+            can run from loop(), yield() or a task of its own, on either
+            core of an ESP32, while read() drains the buffer from one
+            other context. Neither may be called from two contexts.
+
+    @return true if a sample was added to the buffer
+*/
+/**************************************************************************/
+bool Adafruit_ADS1X15_Stream::service() {
+  if (!m_active) {
+    return false;
+  }
+
+  uint32_t timestamp;
+  uint8_t count = m_ads->readyEdges(&timestamp);
+  if (count == m_serviced) {
+    return false;
+  }
+
+  // Any edges beyond the latest one are conversions that were overwritten
+  // before we got to read them
+  m_overruns += (uint8_t)(count - m_serviced - 1);
+  m_serviced = count;
+
+  // A failed read has no sample to buffer
+  int16_t counts;
+  if (m_ads->getLastConversionResults(&counts) != ADS1X15_OK) {
+    m_errors++;
+    return false;
+  }
+  if (m_filter != NULL && !m_filter->process(counts, &counts)) {
+    return false;
+  }
+
+  uint8_t head = m_head;
+  if ((uint8_t)(head - m_tail) > m_mask) {
+    m_overruns++;
+    return false;
+  }
+  adsSample_t &slot = m_buf[head & m_mask];
+  slot.timestamp = timestamp;
+  slot.counts = counts;
+  slot.mux = m_mux;
+  ADS1X15_BARRIER();
+  m_head = head + 1;
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Sets a filter chain to run on each sample before it is
+            buffered. With a decimating filter only the filter outputs are
+            buffered, timestamped with the last input sample.
+
+    @param filter first stage of the chain, or NULL to stop filtering
+*/
+/**************************************************************************/
+void Adafruit_ADS1X15_Stream::setFilter(Adafruit_ADS1X15_Filter *filter) {
+  m_filter = filter;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Returns the number of samples waiting in the buffer.
+
+    @return number of samples read() can return
+*/
+/**************************************************************************/
+uint8_t Adafruit_ADS1X15_Stream::available() { return m_head - m_tail; }
+
+/**************************************************************************/
+/*!
+    @brief  Removes samples from the buffer, oldest first.
+
+    @param out array the samples are copied to
+    @param max maximum number of samples to copy
+
+    @return the number of samples copied
+*/
+/**************************************************************************/
+uint8_t Adafruit_ADS1X15_Stream::read(adsSample_t *out, uint8_t max) {
+  uint8_t tail = m_tail;
+  uint8_t n = m_head - tail;
+  ADS1X15_BARRIER();
+  if (n > max) {
+    n = max;
+  }
+  for (uint8_t i = 0; i < n; i++) {
+    out[i] = m_buf[(uint8_t)(tail + i) & m_mask];
+  }
+  ADS1X15_BARRIER();
+  m_tail = tail + n;
+  return n;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Returns the number of samples lost since start(), either
+            because the buffer was full or because a conversion was
+            replaced before service() read it.
+
+    @return the overrun count
+*/
+/**************************************************************************/
+uint32_t Adafruit_ADS1X15_Stream::getOverruns() { return m_overruns; }
+
+/**************************************************************************/
+/*!
+    @brief  Returns the number of conversions dropped since start()
+            because reading them failed. getStatus() on the driver gives
+            the reason for the latest one.
+
+    @return the failed read count
+*/
+/**************************************************************************/
+uint32_t Adafruit_ADS1X15_Stream::getErrors() { return m_errors; }
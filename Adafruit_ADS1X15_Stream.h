@@ -0,0 +1,52 @@
+/**************************************************************************/
+/*!
+    @file     Adafruit_ADS1X15_Stream.h
+
+    Continuous conversions from one ADS1X15, paced by ALERT/RDY, captured
+    into a caller-supplied ring buffer. The stream keeps its state in this
+    object rather than in the driver, so drivers that never stream don't
+    pay for it.
+
+    BSD license, all text here must be included in any redistribution
+*/
+/**************************************************************************/
+#ifndef __ADS1X15_STREAM_H__
+#define __ADS1X15_STREAM_H__
+
+#include "Adafruit_ADS1X15.h"
+
+/**************************************************************************/
+/*!
+    @brief  Single-producer, single-consumer ring buffer of timestamped
+            conversions. service() is the producer and read() the
+            consumer, so each may run in its own context.
+*/
+/**************************************************************************/
+class Adafruit_ADS1X15_Stream {
+public:
+  Adafruit_ADS1X15_Stream(Adafruit_ADS1X15 *ads);
+
+  bool start(uint16_t mux, adsSample_t *buffer, uint8_t size);
+  void stop();
+  bool service();
+  uint8_t available();
+  uint8_t read(adsSample_t *out, uint8_t max);
+  uint32_t getOverruns();
+  uint32_t getErrors();
+  void setFilter(Adafruit_ADS1X15_Filter *filter);
+
+private:
+  Adafruit_ADS1X15 *m_ads;           ///< Chip being streamed
+  adsSample_t *m_buf;                ///< Ring buffer
+  Adafruit_ADS1X15_Filter *m_filter; ///< Applied before buffering
+  uint32_t m_overruns;               ///< Samples lost while streaming
+  uint32_t m_errors;                 ///< Samples lost to failed reads
+  uint16_t m_mux;                    ///< Mux setting being converted
+  uint8_t m_mask;                    ///< Ring buffer size - 1
+  volatile uint8_t m_head;           ///< Written by the producer
+  volatile uint8_t m_tail;           ///< Written by the consumer
+  uint8_t m_serviced;                ///< ALERT/RDY edges serviced
+  bool m_active;                     ///< A stream is running
+};
+
+#endif
@@ -0,0 +1,518 @@
+/**************************************************************************/
+/*!
+    @file     Adafruit_ADS1X15_Transport.cpp
+
+    Trace replay, counting and Linux /dev/i2c-N transports for the ADS1X15
+    driver. The Linux transport compiles to nothing on Arduino.
+
+    BSD license, all text here must be included in any redistribution
+*/
+/**************************************************************************/
+#include "Adafruit_ADS1X15.h"
+#include "Adafruit_ADS1X15_Transport.h"
+
+/** Register values after power-on, see data sheet Table 8 */
+static const uint16_t POWER_ON_REGS[4] = {0x0000, 0x8583, 0x8000, 0x7FFF};
+
+/**************************************************************************/
+/*!
+    @brief  Instantiates a replay transport
+
+    @param trace recorded transactions, which must outlive this object
+    @param count number of entries in trace
+*/
+/**************************************************************************/
+Adafruit_ADS1X15_ReplayTransport::Adafruit_ADS1X15_ReplayTransport(
+    const adsTraceEntry_t *trace, size_t count) {
+  m_trace = trace;
+  m_count = count;
+  begin();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Rewinds to the start of the recording and clears the counters
+
+    @return true
+*/
+/**************************************************************************/
+bool Adafruit_ADS1X15_ReplayTransport::begin() {
+  m_pos = 0;
+  m_pointer = 0;
+  for (uint8_t i = 0; i < 4; i++) {
+    m_last[i] = POWER_ON_REGS[i];
+  }
+  m_skipped = 0;
+  m_extra = 0;
+  m_mismatches = 0;
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Plays a register write
+
+    @param buffer pointer register, then the value if len is 3
+    @param len number of bytes
+
+    @return false if the recorded write failed
+*/
+/**************************************************************************/
+bool Adafruit_ADS1X15_ReplayTransport::write(const uint8_t *buffer,
+                                             size_t len) {
+  m_pointer = buffer[0] & 0x03;
+  if (len < 3) {
+    return true;
+  }
+  uint16_t value = (buffer[1] << 8) | buffer[2];
+  const adsTraceEntry_t *e = next(m_pointer, 0);
+  m_last[m_pointer] = value;
+  if (e == NULL) {
+    m_extra++;
+    return true;
+  }
+  if (e->value != value) {
+    m_mismatches++;
+  }
+  return !(e->flags & ADS1X15_TRACE_ERROR);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Plays a read of the register the pointer was last set to
+
+    @param buffer where to store the value, MSB first
+    @param len number of bytes, 2
+
+    @return false if the recorded read failed
+*/
+/**************************************************************************/
+bool Adafruit_ADS1X15_ReplayTransport::read(uint8_t *buffer, size_t len) {
+  const adsTraceEntry_t *e = next(m_pointer, ADS1X15_TRACE_READ);
+  if (e == NULL) {
+    m_extra++;
+    if (m_pointer == 0x01) {
+      // Polled more than recorded, the conversion has finished by now
+      m_last[m_pointer] |= 0x8000;
+    }
+  }
+  uint16_t value = m_last[m_pointer];
+  if (len >= 2) {
+    buffer[0] = value >> 8;
+    buffer[1] = value & 0xFF;
+  }
+  return e == NULL || !(e->flags & ADS1X15_TRACE_ERROR);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Plays a pointer write and register read
+
+    @param out pointer register
+    @param outLen number of bytes to write, 1
+    @param in where to store the value, MSB first
+    @param inLen number of bytes to read, 2
+
+    @return false if the recorded read failed
+*/
+/**************************************************************************/
+bool Adafruit_ADS1X15_ReplayTransport::writeThenRead(const uint8_t *out,
+                                                     size_t outLen,
+                                                     uint8_t *in,
+                                                     size_t inLen) {
+  (void)outLen;
+  m_pointer = out[0] & 0x03;
+  return read(in, inLen);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Checks whether every recorded transaction has been played or
+            skipped
+
+    @return true at the end of the recording
+*/
+/**************************************************************************/
+bool Adafruit_ADS1X15_ReplayTransport::finished() { return m_pos >= m_count; }
+
+/**************************************************************************/
+/*!
+    @brief  Gets the number of recorded transactions the driver did not
+            make, e.g. polls saved by a longer initial delay
+
+    @return skipped transactions since begin()
+*/
+/**************************************************************************/
+uint32_t Adafruit_ADS1X15_ReplayTransport::skipped() { return m_skipped; }
+
+/**************************************************************************/
+/*!
+    @brief  Gets the number of transactions the driver made that are not
+            in the recording
+
+    @return extra transactions since begin()
+*/
+/**************************************************************************/
+uint32_t Adafruit_ADS1X15_ReplayTransport::extra() { return m_extra; }
+
+/**************************************************************************/
+/*!
+    @brief  Gets the number of writes whose value differs from the
+            recording
+
+    @return mismatched writes since begin()
+*/
+/**************************************************************************/
+uint32_t Adafruit_ADS1X15_ReplayTransport::mismatches() {
+  return m_mismatches;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Finds the next recorded transaction matching the driver's.
+            A read does not look past the next recorded write, as the
+            write changed what the chip returns.
+
+    @param reg register pointer
+    @param flags ADS1X15_TRACE_READ for a read, 0 for a write
+
+    @return the recorded transaction, or NULL if there is none
+*/
+/**************************************************************************/
+const adsTraceEntry_t *Adafruit_ADS1X15_ReplayTransport::next(uint8_t reg,
+                                                             uint8_t flags) {
+  for (size_t i = m_pos; i < m_count; i++) {
+    const adsTraceEntry_t *e = &m_trace[i];
+    uint8_t kind = e->flags & ADS1X15_TRACE_READ;
+    if (kind == flags && (e->reg & 0x03) == reg) {
+      m_skipped += i - m_pos;
+      m_pos = i + 1;
+      m_last[reg] = e->value;
+      return e;
+    }
+    if (flags == ADS1X15_TRACE_READ && kind != ADS1X15_TRACE_READ) {
+      break;
+    }
+  }
+  return NULL;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Instantiates a counting transport
+
+    @param bus transport that carries the transactions, which must outlive
+           this object
+*/
+/**************************************************************************/
+Adafruit_ADS1X15_CountingTransport::Adafruit_ADS1X15_CountingTransport(
+    Adafruit_ADS1X15_Transport *bus) {
+  m_bus = bus;
+  reset();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Begins the underlying transport. The counters are left alone,
+            so recoveries show up in a benchmark.
+
+    @return true if the device can be reached
+*/
+/**************************************************************************/
+bool Adafruit_ADS1X15_CountingTransport::begin() { return m_bus->begin(); }
+
+/**************************************************************************/
+/*!
+    @brief  Ends the underlying transport
+*/
+/**************************************************************************/
+void Adafruit_ADS1X15_CountingTransport::end() { m_bus->end(); }
+
+/**************************************************************************/
+/*!
+    @brief  Writes bytes to the device, counting one transaction
+
+    @param buffer bytes to write
+    @param len number of bytes
+
+    @return true if the device acknowledged them
+*/
+/**************************************************************************/
+bool Adafruit_ADS1X15_CountingTransport::write(const uint8_t *buffer,
+                                               size_t len) {
+  bool ok = m_bus->write(buffer, len);
+  m_transactions++;
+  m_starts++;
+  m_bytes += len;
+  m_failures += !ok;
+  return ok;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Reads bytes from the device, counting one transaction
+
+    @param buffer where to store the bytes
+    @param len number of bytes
+
+    @return true if successful
+*/
+/**************************************************************************/
+bool Adafruit_ADS1X15_CountingTransport::read(uint8_t *buffer, size_t len) {
+  bool ok = m_bus->read(buffer, len);
+  m_transactions++;
+  m_starts++;
+  m_bytes += len;
+  m_failures += !ok;
+  return ok;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Writes then reads, counting one transaction with a repeated
+            START
+
+    @param out bytes to write
+    @param outLen number of bytes to write
+    @param in where to store the bytes read
+    @param inLen number of bytes to read
+
+    @return true if successful
+*/
+/**************************************************************************/
+bool Adafruit_ADS1X15_CountingTransport::writeThenRead(const uint8_t *out,
+                                                       size_t outLen,
+                                                       uint8_t *in,
+                                                       size_t inLen) {
+  bool ok = m_bus->writeThenRead(out, outLen, in, inLen);
+  m_transactions++;
+  m_starts += 2;
+  m_bytes += outLen + inLen;
+  m_failures += !ok;
+  return ok;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Zeroes the counters
+*/
+/**************************************************************************/
+void Adafruit_ADS1X15_CountingTransport::reset() {
+  m_transactions = 0;
+  m_starts = 0;
+  m_bytes = 0;
+  m_failures = 0;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gets the number of transactions, i.e. STOP conditions
+
+    @return transactions since reset()
+*/
+/**************************************************************************/
+uint32_t Adafruit_ADS1X15_CountingTransport::transactions() {
+  return m_transactions;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gets the number of START and repeated START conditions, each
+            followed by an address byte
+
+    @return STARTs since reset()
+*/
+/**************************************************************************/
+uint32_t Adafruit_ADS1X15_CountingTransport::starts() { return m_starts; }
+
+/**************************************************************************/
+/*!
+    @brief  Gets the number of data bytes moved, not counting the address
+            bytes
+
+    @return bytes since reset()
+*/
+/**************************************************************************/
+uint32_t Adafruit_ADS1X15_CountingTransport::bytes() { return m_bytes; }
+
+/**************************************************************************/
+/*!
+    @brief  Gets the number of transactions that failed
+
+    @return failed transactions since reset()
+*/
+/**************************************************************************/
+uint32_t Adafruit_ADS1X15_CountingTransport::failures() { return m_failures; }
+
+/**************************************************************************/
+/*!
+    @brief  Models the bus time the counted transactions take. Every
+            START and STOP costs a bit time, and every address or data
+            byte nine, with its ACK. Above 1MHz each transaction also
+            pays for the Hs-mode master code, sent at 400kHz. Clock
+            stretching and the gaps between transactions are not
+            included.
+
+    @param clock_hz SCL frequency to model, e.g. 100000
+
+    @return modelled bus time in microseconds since reset()
+*/
+/**************************************************************************/
+float Adafruit_ADS1X15_CountingTransport::busMicros(uint32_t clock_hz) {
+  uint32_t bits = m_starts * 10 + m_bytes * 9 + m_transactions;
+  float us = bits * 1e6f / clock_hz;
+  if (clock_hz > 1000000UL) {
+    // START, master code and NACK before switching to Hs-mode
+    us += m_transactions * 10 * 1e6f / 400000UL;
+  }
+  return us;
+}
+
+#if defined(__linux__) && !defined(ARDUINO)
+
+#include <fcntl.h>
+#include <linux/i2c-dev.h>
+#include <linux/i2c.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+/**************************************************************************/
+/*!
+    @brief  Instantiates a transport. Nothing is opened until begin().
+
+    @param device path of the bus device, e.g. "/dev/i2c-1", which must
+           outlive this object
+    @param i2c_addr 7-bit I2C address of the ADC
+*/
+/**************************************************************************/
+Adafruit_ADS1X15_LinuxI2C::Adafruit_ADS1X15_LinuxI2C(const char *device,
+                                                     uint8_t i2c_addr) {
+  m_device = device;
+  m_i2c_addr = i2c_addr;
+  m_fd = -1;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Closes the bus device
+*/
+/**************************************************************************/
+Adafruit_ADS1X15_LinuxI2C::~Adafruit_ADS1X15_LinuxI2C() { end(); }
+
+/**************************************************************************/
+/*!
+    @brief  Opens the bus device, unless it is already open, and checks
+            that the chip answers by reading its config register
+
+    @return true if successful, otherwise false
+*/
+/**************************************************************************/
+bool Adafruit_ADS1X15_LinuxI2C::begin() {
+  if (m_fd < 0) {
+    m_fd = open(m_device, O_RDWR);
+  }
+  if (m_fd < 0) {
+    return false;
+  }
+  // Opening only proves the bus exists, so probe like
+  // Adafruit_I2CDevice::begin() does on Arduino
+  uint8_t pointer = ADS1X15_REG_POINTER_CONFIG;
+  uint8_t config[2];
+  if (!writeThenRead(&pointer, 1, config, 2)) {
+    end();
+    return false;
+  }
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Closes the bus device
+*/
+/**************************************************************************/
+void Adafruit_ADS1X15_LinuxI2C::end() {
+  if (m_fd >= 0) {
+    close(m_fd);
+    m_fd = -1;
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Writes bytes to the device
+
+    @param buffer bytes to write
+    @param len number of bytes
+
+    @return true if successful, otherwise false
+*/
+/**************************************************************************/
+bool Adafruit_ADS1X15_LinuxI2C::write(const uint8_t *buffer, size_t len) {
+  struct i2c_msg msg;
+  msg.addr = m_i2c_addr;
+  msg.flags = 0;
+  msg.len = len;
+  msg.buf = (uint8_t *)buffer;
+
+  struct i2c_rdwr_ioctl_data xfer;
+  xfer.msgs = &msg;
+  xfer.nmsgs = 1;
+  return m_fd >= 0 && ioctl(m_fd, I2C_RDWR, &xfer) == 1;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Reads bytes from the device
+
+    @param buffer where to store the bytes
+    @param len number of bytes
+
+    @return true if successful, otherwise false
+*/
+/**************************************************************************/
+bool Adafruit_ADS1X15_LinuxI2C::read(uint8_t *buffer, size_t len) {
+  struct i2c_msg msg;
+  msg.addr = m_i2c_addr;
+  msg.flags = I2C_M_RD;
+  msg.len = len;
+  msg.buf = buffer;
+
+  struct i2c_rdwr_ioctl_data xfer;
+  xfer.msgs = &msg;
+  xfer.nmsgs = 1;
+  return m_fd >= 0 && ioctl(m_fd, I2C_RDWR, &xfer) == 1;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Writes then reads with a repeated START in between, in one
+            ioctl, so a register read costs a single system call
+
+    @param out bytes to write
+    @param outLen number of bytes to write
+    @param in where to store the bytes read
+    @param inLen number of bytes to read
+
+    @return true if successful, otherwise false
+*/
+/**************************************************************************/
+bool Adafruit_ADS1X15_LinuxI2C::writeThenRead(const uint8_t *out,
+                                              size_t outLen, uint8_t *in,
+                                              size_t inLen) {
+  struct i2c_msg msgs[2];
+  msgs[0].addr = m_i2c_addr;
+  msgs[0].flags = 0;
+  msgs[0].len = outLen;
+  msgs[0].buf = (uint8_t *)out;
+  msgs[1].addr = m_i2c_addr;
+  msgs[1].flags = I2C_M_RD;
+  msgs[1].len = inLen;
+  msgs[1].buf = in;
+
+  struct i2c_rdwr_ioctl_data xfer;
+  xfer.msgs = msgs;
+  xfer.nmsgs = 2;
+  return m_fd >= 0 && ioctl(m_fd, I2C_RDWR, &xfer) == 2;
+}
+
+#endif
@@ -0,0 +1,280 @@
+/**************************************************************************/
+/*!
+    @file     Adafruit_ADS1X15_Transport.h
+
+    Bus access used by the ADS1X15 register layer. On Arduino the driver
+    talks to the chip through an Adafruit_I2CDevice; on Linux it can use
+    the /dev/i2c-N character device instead, and any other bus (or a
+    simulated chip) can be plugged in by implementing the interface.
+
+    BSD license, all text here must be included in any redistribution
+*/
+/**************************************************************************/
+#ifndef __ADS1X15_TRANSPORT_H__
+#define __ADS1X15_TRANSPORT_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef ARDUINO
+#include <Adafruit_I2CDevice.h>
+#endif
+
+#define ADS1X15_TRACE_READ (0x01)    ///< Register read, else a write
+#define ADS1X15_TRACE_POINTER (0x02) ///< Read also wrote the pointer register
+#define ADS1X15_TRACE_ERROR (0x80)   ///< Transaction failed
+
+/** One register transaction, see Adafruit_ADS1X15::setTrace() */
+typedef struct {
+  uint32_t timestamp; ///< micros() when the transaction finished
+  uint16_t value;     ///< Value written or read
+  uint8_t reg;        ///< Register pointer
+  uint8_t flags;      ///< ADS1X15_TRACE_* bits
+} adsTraceEntry_t;
+
+/**************************************************************************/
+/*!
+    @brief  Moves bytes to and from one ADS1X15 on a bus. Each call is one
+            complete bus transaction.
+*/
+/**************************************************************************/
+class Adafruit_ADS1X15_Transport {
+public:
+  /*!
+      @brief  Releases the bus, subclasses may be deleted through this
+  */
+  virtual ~Adafruit_ADS1X15_Transport() {}
+
+  /*!
+      @brief  Prepares the bus, may be called again to recover it
+      @return true if the device can be reached
+  */
+  virtual bool begin() = 0;
+
+  /*!
+      @brief  Releases the bus, e.g. so its pins can be driven directly.
+              begin() takes it back.
+  */
+  virtual void end() {}
+
+  /*!
+      @brief  Writes bytes to the device
+      @param buffer bytes to write
+      @param len number of bytes
+      @return true if the device acknowledged them
+  */
+  virtual bool write(const uint8_t *buffer, size_t len) = 0;
+
+  /*!
+      @brief  Reads bytes from the device
+      @param buffer where to store the bytes
+      @param len number of bytes
+      @return true if successful
+  */
+  virtual bool read(uint8_t *buffer, size_t len) = 0;
+
+  /*!
+      @brief  Writes then reads. Buses that support a repeated START
+              should override this to do both in one transaction.
+      @param out bytes to write
+      @param outLen number of bytes to write
+      @param in where to store the bytes read
+      @param inLen number of bytes to read
+      @return true if successful
+  */
+  virtual bool writeThenRead(const uint8_t *out, size_t outLen, uint8_t *in,
+                             size_t inLen) {
+    return write(out, outLen) && read(in, inLen);
+  }
+};
+
+#ifdef ARDUINO
+/**************************************************************************/
+/*!
+    @brief  Transport over an Adafruit_I2CDevice, the default on Arduino
+*/
+/**************************************************************************/
+class Adafruit_ADS1X15_I2CTransport : public Adafruit_ADS1X15_Transport {
+public:
+  /*!
+      @brief  Instantiates a transport
+      @param i2c_dev I2C device for the ADC, which must outlive this object
+      @param wire the bus i2c_dev is on, if end() should release it where
+             Adafruit_I2CDevice::end() does not
+  */
+  Adafruit_ADS1X15_I2CTransport(Adafruit_I2CDevice *i2c_dev,
+                                TwoWire *wire = NULL)
+      : m_i2c_dev(i2c_dev), m_wire(wire) {}
+
+  /*!
+      @brief  Starts the I2C bus and checks the device answers
+      @return true if successful
+  */
+  bool begin() { return m_i2c_dev->begin(); }
+
+  /*!
+      @brief  Stops the I2C bus, releasing its pins
+  */
+  void end() {
+    m_i2c_dev->end();
+#if defined(ARDUINO_ARCH_ESP32) && defined(ESP_ARDUINO_VERSION_MAJOR)
+#if ESP_ARDUINO_VERSION_MAJOR >= 2
+    // Adafruit_I2CDevice::end() leaves the bus running on ESP32
+    if (m_wire != NULL) {
+      m_wire->end();
+    }
+#endif
+#endif
+  }
+
+  /*!
+      @brief  Writes bytes to the device
+      @param buffer bytes to write
+      @param len number of bytes
+      @return true if successful
+  */
+  bool write(const uint8_t *buffer, size_t len) {
+    return m_i2c_dev->write(buffer, len);
+  }
+
+  /*!
+      @brief  Reads bytes from the device
+      @param buffer where to store the bytes
+      @param len number of bytes
+      @return true if successful
+  */
+  bool read(uint8_t *buffer, size_t len) {
+    return m_i2c_dev->read(buffer, len);
+  }
+
+  /*!
+      @brief  Writes then reads with a repeated START in between
+      @param out bytes to write
+      @param outLen number of bytes to write
+      @param in where to store the bytes read
+      @param inLen number of bytes to read
+      @return true if successful
+  */
+  bool writeThenRead(const uint8_t *out, size_t outLen, uint8_t *in,
+                     size_t inLen) {
+    return m_i2c_dev->write_then_read(out, outLen, in, inLen, false);
+  }
+
+private:
+  Adafruit_I2CDevice *m_i2c_dev; ///< I2C bus device
+  TwoWire *m_wire;               ///< Bus of m_i2c_dev, or NULL
+};
+#endif
+
+/**************************************************************************/
+/*!
+    @brief  Passes transactions on to another transport and counts what
+            they cost on the wire, so the bus time of each driver call
+            can be measured or modelled, e.g. by the benchmark example.
+
+            Each write() or read() is a START, the address byte, the data
+            bytes and a STOP. A writeThenRead() adds a repeated START and
+            a second address byte, which assumes the transport passed in
+            overrides it with a single transaction, as the I2C and Linux
+            transports do.
+*/
+/**************************************************************************/
+class Adafruit_ADS1X15_CountingTransport : public Adafruit_ADS1X15_Transport {
+public:
+  Adafruit_ADS1X15_CountingTransport(Adafruit_ADS1X15_Transport *bus);
+  bool begin();
+  void end();
+  bool write(const uint8_t *buffer, size_t len);
+  bool read(uint8_t *buffer, size_t len);
+  bool writeThenRead(const uint8_t *out, size_t outLen, uint8_t *in,
+                     size_t inLen);
+  void reset();
+  uint32_t transactions();
+  uint32_t starts();
+  uint32_t bytes();
+  uint32_t failures();
+  float busMicros(uint32_t clock_hz);
+
+private:
+  Adafruit_ADS1X15_Transport *m_bus; ///< Transport doing the work
+  uint32_t m_transactions;           ///< STOPs sent
+  uint32_t m_starts;                 ///< STARTs and repeated STARTs sent
+  uint32_t m_bytes;                  ///< Data bytes, without addresses
+  uint32_t m_failures;               ///< Transactions that failed
+};
+
+/**************************************************************************/
+/*!
+    @brief  Plays a recorded trace back to the driver, e.g. on a host, so
+            the bus traffic of a new driver version can be compared with
+            a recording from the field.
+
+            Transactions are matched in order: each read returns the next
+            recorded read of the same register and each write moves to
+            the next recorded write to that register. Recorded
+            transactions the driver no longer makes are counted by
+            skipped(), extra ones by extra(), and writes of a different
+            value by mismatches(). Extra reads repeat the last value of
+            the register, with the config register's OS bit set so extra
+            polling sees the conversion as complete.
+*/
+/**************************************************************************/
+class Adafruit_ADS1X15_ReplayTransport : public Adafruit_ADS1X15_Transport {
+public:
+  Adafruit_ADS1X15_ReplayTransport(const adsTraceEntry_t *trace, size_t count);
+  bool begin();
+  bool write(const uint8_t *buffer, size_t len);
+  bool read(uint8_t *buffer, size_t len);
+  bool writeThenRead(const uint8_t *out, size_t outLen, uint8_t *in,
+                     size_t inLen);
+  bool finished();
+  uint32_t skipped();
+  uint32_t extra();
+  uint32_t mismatches();
+
+private:
+  const adsTraceEntry_t *next(uint8_t reg, uint8_t flags);
+
+  const adsTraceEntry_t *m_trace; ///< Recording being played back
+  size_t m_count;                 ///< Entries in m_trace
+  size_t m_pos;                   ///< Next entry to play
+  uint8_t m_pointer;              ///< Register a plain read() returns
+  uint16_t m_last[4];             ///< Last value played per register
+  uint32_t m_skipped;             ///< Recorded transactions not made
+  uint32_t m_extra;               ///< Transactions not in the recording
+  uint32_t m_mismatches;          ///< Writes of a different value
+};
+
+#if defined(__linux__) && !defined(ARDUINO)
+/**************************************************************************/
+/*!
+    @brief  Transport over a Linux /dev/i2c-N device. Every transaction,
+            including a pointer write followed by a read, is a single
+            I2C_RDWR ioctl.
+*/
+/**************************************************************************/
+class Adafruit_ADS1X15_LinuxI2C : public Adafruit_ADS1X15_Transport {
+public:
+  Adafruit_ADS1X15_LinuxI2C(const char *device, uint8_t i2c_addr);
+  ~Adafruit_ADS1X15_LinuxI2C();
+  bool begin();
+  void end();
+  bool write(const uint8_t *buffer, size_t len);
+  bool read(uint8_t *buffer, size_t len);
+  bool writeThenRead(const uint8_t *out, size_t outLen, uint8_t *in,
+                     size_t inLen);
+
+  /** The file descriptor is owned, so copies are not allowed */
+  Adafruit_ADS1X15_LinuxI2C(const Adafruit_ADS1X15_LinuxI2C &) = delete;
+  /** The file descriptor is owned, so copies are not allowed */
+  Adafruit_ADS1X15_LinuxI2C &
+  operator=(const Adafruit_ADS1X15_LinuxI2C &) = delete;
+
+private:
+  const char *m_device; ///< Path of the bus device, e.g. "/dev/i2c-1"
+  uint8_t m_i2c_addr;   ///< 7-bit device address
+  int m_fd;             ///< Open bus device, or -1
+};
+#endif
+
+#endif
@@ -0,0 +1,74 @@
+#include <Adafruit_ADS1X15.h>
+#include <Adafruit_ADS1X15_BlockStats.h>
+
+Adafruit_ADS1115 ads;  /* Use this for the 16-bit version */
+// Adafruit_ADS1015 ads;     /* Use this for the 12-bit version */
+
+// Pin connected to the ALERT/RDY signal for new sample notification.
+constexpr int READY_PIN = 3;
+
+// One window of raw conversions. Each reading waits for ALERT/RDY, so
+// the window is consecutive conversions at the chip's own 860SPS, and
+// 172 of them cover ten cycles of 50Hz mains. Without RDY, readBurst()
+// paces reads by a timer at about 780SPS and skips conversions, so the
+// window would not span a whole number of cycles.
+constexpr size_t WINDOW = 172;
+int16_t samples[WINDOW];
+
+Adafruit_ADS1X15_BlockStats stats;
+
+// This is required on ESP32 to put the ISR in IRAM. Define as
+// empty for other platforms. Be careful - other platforms may have
+// other requirements.
+#ifndef IRAM_ATTR
+#define IRAM_ATTR
+#endif
+
+volatile bool new_data = false;
+void IRAM_ATTR NewDataReadyISR() {
+  new_data = true;
+}
+
+void setup(void)
+{
+  Serial.begin(115200);
+  Serial.println("Hello!");
+
+  Serial.println("AC RMS of AIN0 (P) - AIN1 (N), e.g. a current transformer");
+
+  if (!ads.begin()) {
+    Serial.println("Failed to initialize ADS.");
+    while (1);
+  }
+
+  ads.setGain(GAIN_FOUR);
+  ads.setDataRate(RATE_ADS1115_860SPS);
+
+  pinMode(READY_PIN, INPUT);
+  // We get a falling edge every time a new sample is ready.
+  attachInterrupt(digitalPinToInterrupt(READY_PIN), NewDataReadyISR, FALLING);
+}
+
+void loop(void)
+{
+  size_t n = ads.readBurst(ADS1X15_REG_CONFIG_MUX_DIFF_0_1, samples, WINDOW,
+                           &new_data);
+  if (n < WINDOW) {
+    Serial.println("Timed out waiting for ALERT/RDY, check READY_PIN.");
+    delay(1000);
+    return;
+  }
+
+  // All the arithmetic is done in counts, only the results are
+  // converted to volts
+  stats.reset();
+  stats.add(samples, n);
+  adsBlockVolts_t volts;
+  stats.getVolts(&volts, ads);
+
+  Serial.print("DC: "); Serial.print(volts.mean, 5); Serial.print("V  ");
+  Serial.print("AC RMS: "); Serial.print(volts.acRMS, 5); Serial.print("V  ");
+  Serial.print("Peak-to-peak: "); Serial.print(volts.peakToPeak, 5); Serial.println("V");
+
+  delay(1000);
+}
@@ -0,0 +1,129 @@
+#include <Adafruit_ADS1X15_Scan.h>
+
+// Adafruit_ADS1115 ads;  /* Use this for the 16-bit version */
+Adafruit_ADS1015 ads;     /* Use this for the 12-bit version */
+
+// The driver talks to the chip through a transport that counts every
+// transaction, START and byte on the way to the real bus
+Adafruit_I2CDevice i2c_dev(ADS1X15_ADDRESS, &Wire);
+Adafruit_ADS1X15_I2CTransport i2c(&i2c_dev);
+Adafruit_ADS1X15_CountingTransport bus(&i2c);
+
+Adafruit_ADS1X15_Scan scan(&ads);
+
+// Times each driver call on the real bus and prints the results as CSV,
+// so runs before and after a driver change can be diffed. Transactions
+// (STOPs), STARTs and data bytes are counted per call, and the bus time
+// they take is modelled at 100kHz, 400kHz and 3.4MHz from those counts.
+//
+//   call,<clock_hz>,<name>,<us_per_call>,<transactions>,<starts>,<bytes>,
+//        <bus_us_100k>,<bus_us_400k>,<bus_us_3m4>
+//   sweep,<clock_hz>,<rate_code>,<nominal_sps>,<samples_per_second>,
+//        <transactions>,<starts>,<bytes>,<bus_us_100k>,<bus_us_400k>,
+//        <bus_us_3m4>
+//
+// Counts and bus times are per call, or per sample for sweeps.
+// tests/benchmark.cpp prints the same counts on a host, against a
+// simulated chip, for tracking regressions without hardware.
+
+constexpr uint16_t ITERATIONS = 50;
+constexpr uint8_t SWEEPS = 10;
+const uint32_t CLOCKS[] = { 100000, 400000 };
+const uint32_t MODELLED[] = { 100000, 400000, 3400000 };
+
+const adsScanEntry_t sweep[] = {
+  { MUX_BY_CHANNEL[0], GAIN_TWOTHIRDS },
+  { MUX_BY_CHANNEL[1], GAIN_TWOTHIRDS },
+  { MUX_BY_CHANNEL[2], GAIN_TWOTHIRDS },
+  { MUX_BY_CHANNEL[3], GAIN_TWOTHIRDS },
+};
+int16_t results[4];
+
+typedef void (*benchFunc)();
+
+void printCosts(uint32_t n)
+{
+  Serial.print((float)bus.transactions() / n); Serial.print(",");
+  Serial.print((float)bus.starts() / n); Serial.print(",");
+  Serial.print((float)bus.bytes() / n);
+  for (uint32_t clock : MODELLED) {
+    Serial.print(","); Serial.print(bus.busMicros(clock) / n);
+  }
+  Serial.println();
+}
+
+void benchCall(uint32_t clock, const char *name, benchFunc func)
+{
+  bus.reset();
+  uint32_t start = micros();
+  for (uint16_t i = 0; i < ITERATIONS; i++) {
+    func();
+  }
+  uint32_t elapsed = micros() - start;
+
+  Serial.print("call,"); Serial.print(clock); Serial.print(",");
+  Serial.print(name); Serial.print(",");
+  Serial.print((float)elapsed / ITERATIONS); Serial.print(",");
+  printCosts(ITERATIONS);
+}
+
+void benchSweep(uint32_t clock, uint16_t rate)
+{
+  ads.setDataRate(rate);
+  bus.reset();
+  scan.start(sweep, 4, results);
+  uint8_t done = 0;
+  uint32_t start = micros();
+  while (done < SWEEPS) {
+    if (scan.update()) {
+      done++;
+    }
+  }
+  uint32_t elapsed = micros() - start;
+  scan.stop();
+
+  Serial.print("sweep,"); Serial.print(clock); Serial.print(",");
+  Serial.print(rate >> 5); Serial.print(",");
+  Serial.print(1000000UL / ads.getConversionDelay()); Serial.print(",");
+  Serial.print(SWEEPS * 4 * 1000000.0 / elapsed); Serial.print(",");
+  printCosts(SWEEPS * 4);
+}
+
+void setup(void)
+{
+  Serial.begin(115200);
+  while (!Serial) delay(10);
+
+  if (!ads.begin(&bus)) {
+    Serial.println("Failed to initialize ADS.");
+    while (1);
+  }
+
+  uint16_t defaultRate = ads.getDataRate();
+
+  for (uint32_t clock : CLOCKS) {
+    Wire.setClock(clock);
+    ads.setDataRate(defaultRate);
+
+    benchCall(clock, "readADC_SingleEnded", [] { ads.readADC_SingleEnded(0); });
+    benchCall(clock, "readADC_Differential_0_1", [] { ads.readADC_Differential_0_1(); });
+    benchCall(clock, "readADC_Differential_0_3", [] { ads.readADC_Differential_0_3(); });
+    benchCall(clock, "readADC_Differential_1_3", [] { ads.readADC_Differential_1_3(); });
+    benchCall(clock, "readADC_Differential_2_3", [] { ads.readADC_Differential_2_3(); });
+    benchCall(clock, "startADCReading", [] { ads.startADCReading(MUX_BY_CHANNEL[0], false); });
+    benchCall(clock, "conversionComplete", [] { ads.conversionComplete(); });
+    benchCall(clock, "getLastConversionResults", [] { ads.getLastConversionResults(); });
+    benchCall(clock, "startComparator_SingleEnded", [] { ads.startComparator_SingleEnded(0, 1000); });
+
+    for (uint16_t rate = 0; rate <= ADS1X15_REG_CONFIG_RATE_MASK; rate += 0x20) {
+      benchSweep(clock, rate);
+    }
+  }
+
+  ads.setDataRate(defaultRate);
+  Serial.println("done");
+}
+
+void loop(void)
+{
+}
@@ -0,0 +1,68 @@
+#include <Adafruit_ADS1X15.h>
+#include <Adafruit_ADS1X15_Log.h>
+
+// Adafruit_ADS1115 ads;  /* Use this for the 16-bit version */
+Adafruit_ADS1015 ads;     /* Use this for the 12-bit version */
+
+// Pin connected to the ALERT/RDY signal for new sample notification.
+constexpr int READY_PIN = 3;
+
+// Passes encoded bytes to the serial port. Capture the output to a file
+// on the host and decode it with tools/ads1x15_decode.cpp.
+void writeSerial(void *context, const uint8_t *data, size_t len) {
+  ((Print *)context)->write(data, len);
+}
+
+// One channel is logged, in blocks of 16 readings.
+Adafruit_ADS1X15_LogEncoder<1, 16> encoder(writeSerial, &Serial);
+
+// This is required on ESP32 to put the ISR in IRAM. Define as
+// empty for other platforms. Be careful - other platforms may have
+// other requirements.
+#ifndef IRAM_ATTR
+#define IRAM_ATTR
+#endif
+
+volatile bool new_data = false;
+void IRAM_ATTR NewDataReadyISR() {
+  new_data = true;
+}
+
+void setup(void)
+{
+  // No text is printed, the serial output is the binary log only.
+  Serial.begin(115200);
+
+  if (!ads.begin()) {
+    while (1);
+  }
+
+  // At 3300SPS the packed 12-bit readings need about 5000 bytes/s, well
+  // within the 11520 bytes/s a 115200 baud link carries.
+  ads.setDataRate(RATE_ADS1015_3300SPS);
+
+  adsLogHeader_t header;
+  header.bits = ads.getResolution();
+  header.gain = ads.getGain() >> 9;
+  header.rate = ads.getDataRate() >> 5;
+  header.channels = 1;
+  encoder.begin(&header);
+
+  pinMode(READY_PIN, INPUT);
+  // We get a falling edge every time a new sample is ready.
+  attachInterrupt(digitalPinToInterrupt(READY_PIN), NewDataReadyISR, FALLING);
+
+  // Start continuous conversions.
+  ads.startADCReading(ADS1X15_REG_CONFIG_MUX_DIFF_0_1, /*continuous=*/true);
+}
+
+void loop(void)
+{
+  // If we don't have new data, skip this iteration.
+  if (!new_data) {
+    return;
+  }
+  new_data = false;
+
+  encoder.push(0, ads.getLastConversionResults());
+}
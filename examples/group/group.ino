@@ -0,0 +1,49 @@
+#include <Adafruit_ADS1X15_Group.h>
+
+// Four chips on one bus, one for each ADDR pin setting.
+Adafruit_ADS1115 ads0;
+Adafruit_ADS1115 ads1;
+Adafruit_ADS1115 ads2;
+Adafruit_ADS1115 ads3;
+
+Adafruit_ADS1X15_Group group;
+
+void setup(void)
+{
+  Serial.begin(9600);
+  Serial.println("Hello!");
+
+  Serial.println("Reading 16 single-ended channels from 4 chips");
+
+  if (!ads0.begin(ADS1X15_ADDRESS) || !ads1.begin(ADS1X15_ADDRESS + 1) ||
+      !ads2.begin(ADS1X15_ADDRESS + 2) || !ads3.begin(ADS1X15_ADDRESS + 3)) {
+    Serial.println("Failed to initialize ADS.");
+    while (1);
+  }
+
+  group.add(&ads0);
+  group.add(&ads1);
+  group.add(&ads2);
+  group.add(&ads3);
+}
+
+void loop(void)
+{
+  int16_t results[4][ADS1X15_GROUP_MAX];
+
+  // All four chips convert each channel at the same time.
+  for (uint8_t channel = 0; channel < 4; channel++) {
+    group.readAll(MUX_BY_CHANNEL[channel], results[channel]);
+  }
+
+  Serial.println("-----------------------------------------------------------");
+  for (uint8_t chip = 0; chip < group.size(); chip++) {
+    Serial.print("Chip "); Serial.print(chip); Serial.print(":");
+    for (uint8_t channel = 0; channel < 4; channel++) {
+      Serial.print("  "); Serial.print(results[channel][chip]);
+    }
+    Serial.println();
+  }
+
+  delay(1000);
+}
@@ -0,0 +1,49 @@
+#include <Adafruit_ADS1X15_Scan.h>
+
+// Adafruit_ADS1115 ads;  /* Use this for the 16-bit version */
+Adafruit_ADS1015 ads;     /* Use this for the 12-bit version */
+
+Adafruit_ADS1X15_Scan scan(&ads);
+
+// Channels to scan, each with its own gain. Be careful never to exceed
+// VDD +0.3V max on any input, whatever gain is used!
+const adsScanEntry_t sequence[] = {
+  { MUX_BY_CHANNEL[0], GAIN_TWOTHIRDS },
+  { MUX_BY_CHANNEL[1], GAIN_TWOTHIRDS },
+  { ADS1X15_REG_CONFIG_MUX_DIFF_2_3, GAIN_FOUR },
+};
+constexpr uint8_t NUM_STEPS = sizeof(sequence) / sizeof(sequence[0]);
+
+int16_t results[NUM_STEPS];
+
+void setup(void)
+{
+  Serial.begin(9600);
+  Serial.println("Hello!");
+
+  Serial.println("Scanning AIN0, AIN1 and AIN2-AIN3 without blocking");
+
+  if (!ads.begin()) {
+    Serial.println("Failed to initialize ADS.");
+    while (1);
+  }
+
+  // Start scanning. A new sweep starts as soon as one finishes.
+  scan.start(sequence, NUM_STEPS, results);
+}
+
+void loop(void)
+{
+  // Advance the scan. This returns straight away if the current
+  // conversion isn't finished yet, so other work can go here too.
+  if (!scan.update()) {
+    return;
+  }
+
+  Serial.println("-----------------------------------------------------------");
+  for (uint8_t i = 0; i < NUM_STEPS; i++) {
+    Serial.print("Step "); Serial.print(i); Serial.print(": ");
+    Serial.print(results[i]); Serial.print("  ");
+    Serial.print(ads.computeVolts(results[i], sequence[i].gain)); Serial.println("V");
+  }
+}
@@ -0,0 +1,66 @@
+#include <Adafruit_ADS1X15_Scan.h>
+
+Adafruit_ADS1115 ads;  /* Use this for the 16-bit version */
+// Adafruit_ADS1015 ads;     /* Use this for the 12-bit version */
+
+Adafruit_ADS1X15_Scan scan(&ads);
+
+// Channels and the sample rate each one needs. A slow channel such as a
+// temperature sensor gets a slow, low noise data rate, while a fast
+// channel such as a current sense gets a faster one.
+adsScanTarget_t targets[] = {
+  { MUX_BY_CHANNEL[0], GAIN_ONE, 8.0f, 0 },    // temperature, 8 SPS
+  { MUX_BY_CHANNEL[1], GAIN_EIGHT, 200.0f, 0 }, // current, 200 SPS
+};
+constexpr uint8_t NUM_TARGETS = sizeof(targets) / sizeof(targets[0]);
+
+// The planned scan, and one result per step
+constexpr uint8_t MAX_STEPS = 64;
+adsScanEntry_t table[MAX_STEPS];
+int16_t results[MAX_STEPS];
+uint8_t numSteps;
+
+void setup(void)
+{
+  Serial.begin(115200);
+  Serial.println("Hello!");
+
+  if (!ads.begin()) {
+    Serial.println("Failed to initialize ADS.");
+    while (1);
+  }
+
+  float load;
+  if (!ads.planScan(targets, NUM_TARGETS, table, MAX_STEPS, &numSteps, &load)) {
+    Serial.println("Sample rates can't be met on this chip!");
+  }
+  Serial.print("Steps per cycle: "); Serial.println(numSteps);
+  Serial.print("Load: "); Serial.println(load);
+  for (uint8_t i = 0; i < NUM_TARGETS; i++) {
+    Serial.print("Channel "); Serial.print(i);
+    Serial.print(" data rate field: 0x"); Serial.println(targets[i].rate, HEX);
+  }
+
+  if (numSteps != 0) {
+    scan.start(table, numSteps, results);
+  }
+}
+
+void loop(void)
+{
+  if (!scan.update()) {
+    return;
+  }
+
+  // Once per cycle, print the latest result of each channel
+  for (uint8_t i = 0; i < NUM_TARGETS; i++) {
+    for (uint8_t step = numSteps; step-- > 0;) {
+      if (table[step].mux == targets[i].mux) {
+        Serial.print(ads.computeVolts(results[step], targets[i].gain), 4);
+        Serial.print("V  ");
+        break;
+      }
+    }
+  }
+  Serial.println();
+}
@@ -0,0 +1,70 @@
+#include <Adafruit_ADS1X15_Stream.h>
+
+// Adafruit_ADS1115 ads;  /* Use this for the 16-bit version */
+Adafruit_ADS1015 ads;     /* Use this for the 12-bit version */
+
+Adafruit_ADS1X15_Stream stream(&ads);
+
+// Pin connected to the ALERT/RDY signal for new sample notification.
+constexpr int READY_PIN = 3;
+
+// Ring buffer for the captured samples. The size must be a power of two,
+// no larger than 128.
+constexpr uint8_t BUFFER_SIZE = 64;
+adsSample_t buffer[BUFFER_SIZE];
+
+// This is required on ESP32 to put the ISR in IRAM. Define as
+// empty for other platforms. Be careful - other platforms may have
+// other requirements.
+#ifndef IRAM_ATTR
+#define IRAM_ATTR
+#endif
+
+void IRAM_ATTR NewDataReadyISR() {
+  // Only records the time of the edge, the I2C read happens in
+  // stream.service()
+  ads.dataReadyISR();
+}
+
+void setup(void)
+{
+  Serial.begin(115200);
+  Serial.println("Hello!");
+
+  Serial.println("Streaming differential readings from AIN0 (P) and AIN1 (N)");
+
+  if (!ads.begin()) {
+    Serial.println("Failed to initialize ADS.");
+    while (1);
+  }
+
+  ads.setDataRate(RATE_ADS1015_920SPS);
+
+  pinMode(READY_PIN, INPUT);
+  // We get a falling edge every time a new sample is ready.
+  attachInterrupt(digitalPinToInterrupt(READY_PIN), NewDataReadyISR, FALLING);
+
+  // Start continuous conversions into the ring buffer.
+  stream.start(ADS1X15_REG_CONFIG_MUX_DIFF_0_1, buffer, BUFFER_SIZE);
+}
+
+void loop(void)
+{
+  // Read the latest conversion into the buffer, if there is one. Call this
+  // often; anything slow in loop() should call it too.
+  stream.service();
+
+  // Drain the buffer in batches.
+  if (stream.available() < 16) {
+    return;
+  }
+
+  adsSample_t batch[16];
+  uint8_t n = stream.read(batch, 16);
+  for (uint8_t i = 0; i < n; i++) {
+    stream.service();
+    Serial.print(batch[i].timestamp); Serial.print(","); Serial.println(batch[i].counts);
+  }
+
+  Serial.print("Overruns: "); Serial.println(stream.getOverruns());
+}
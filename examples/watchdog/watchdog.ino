@@ -0,0 +1,54 @@
+#include <Adafruit_ADS1X15.h>
+
+Adafruit_ADS1115 ads;  /* Use this for the 16-bit version */
+// Adafruit_ADS1015 ads;     /* Use this for the 12-bit version */
+
+const char *statusName(adsStatus_t status)
+{
+  switch (status) {
+  case ADS1X15_OK: return "ok";
+  case ADS1X15_ERR_ARGUMENT: return "bad argument";
+  case ADS1X15_ERR_BUS: return "bus error";
+  case ADS1X15_ERR_TIMEOUT: return "timed out";
+  case ADS1X15_ERR_OFFLINE: return "offline";
+  }
+  return "?";
+}
+
+void setup(void)
+{
+  Serial.begin(9600);
+  Serial.println("Hello!");
+
+  Serial.println("Reading AIN0, carrying on through bus faults");
+
+  if (!ads.begin()) {
+    Serial.println("Failed to initialize ADS.");
+    while (1);
+  }
+
+  // Give up on a stuck conversion early and recover the chip
+  ads.setWatchdog(true);
+  // After 5 failures in a row, leave the bus alone for a second
+  ads.setCircuitBreaker(5, 1000);
+  // Uncomment to clock a stuck chip off the bus, using your board's pins
+  // ads.setBusClearPins(SCL, SDA);
+}
+
+void loop(void)
+{
+  int16_t adc0;
+  adsStatus_t status = ads.readADC_SingleEnded(0, &adc0);
+
+  if (status == ADS1X15_OK) {
+    Serial.print("AIN0: "); Serial.print(adc0); Serial.print("  ");
+    Serial.print(ads.computeVolts(adc0)); Serial.println("V");
+  } else {
+    Serial.print("AIN0: "); Serial.print(statusName(status));
+    Serial.print("  failures: "); Serial.print(ads.getConsecutiveFailures());
+    Serial.print("  recoveries: "); Serial.print(ads.getRecoveries());
+    Serial.println(ads.circuitOpen() ? "  (breaker open)" : "");
+  }
+
+  delay(1000);
+}
@@ -0,0 +1,356 @@
+/**************************************************************************/
+/*!
+    @file     ads1x15_fake.h
+
+    In-process model of an ADS1015/ADS1115 register file, plugged into
+    the driver as a transport so the driver's logic can be tested on a
+    host without hardware. It models the config register and OS bit,
+    conversion timing per data rate, single-shot and continuous modes,
+    the comparator with its ALERT/RDY output, and failed transactions.
+
+    BSD license, all text here must be included in any redistribution
+*/
+/**************************************************************************/
+#ifndef __ADS1X15_FAKE_H__
+#define __ADS1X15_FAKE_H__
+
+#include "Adafruit_ADS1X15.h"
+
+/**************************************************************************/
+/*!
+    @brief  A simulated ADS1X15 on the other end of the bus
+*/
+/**************************************************************************/
+class FakeADS1X15 : public Adafruit_ADS1X15_Transport {
+public:
+  /*!
+      @brief  Instantiates a chip in its power-on state
+      @param bits 12 for an ADS1015, 16 for an ADS1115
+  */
+  FakeADS1X15(uint8_t bits = 16) : m_bits(bits) {
+    for (uint8_t i = 0; i < 8; i++) {
+      m_inputs[i] = 0;
+    }
+    m_percent = 100;
+    m_failures = 0;
+    m_failAfter = 0;
+    m_present = true;
+    m_begun = true;
+    writes = reads = combined = bytes = begins = ends = 0;
+    powerOn();
+  }
+
+  /*!
+      @brief  Resets the registers to their power-on values
+  */
+  void powerOn() {
+    m_regs[ADS1X15_REG_POINTER_CONVERT] = 0x0000;
+    m_regs[ADS1X15_REG_POINTER_CONFIG] = 0x8583;
+    m_regs[ADS1X15_REG_POINTER_LOWTHRESH] = 0x8000;
+    m_regs[ADS1X15_REG_POINTER_HITHRESH] = 0x7FFF;
+    m_pointer = 0;
+    m_single = false;
+    m_continuous = false;
+    m_start = 0;
+    m_done = 0;
+    m_alert = false;
+    m_beyond = 0;
+    readyPulses = 0;
+  }
+
+  /*!
+      @brief  Sets the voltage the chip sees on one mux setting
+      @param mux mux field value
+      @param volts input voltage, P - N
+  */
+  void setInput(uint16_t mux, float volts) {
+    m_inputs[(mux & ADS1X15_REG_CONFIG_MUX_MASK) >> 12] = volts;
+  }
+
+  /*!
+      @brief  Sets how long conversions take
+      @param percent of the nominal conversion time, 0 to finish
+             conversions straight away and 110 for the slowest oscillator
+  */
+  void setTiming(uint16_t percent) { m_percent = percent; }
+
+  /*!
+      @brief  Makes transactions fail as if the chip did not acknowledge
+      @param count number of transactions to fail
+      @param after number of transactions to let through first
+  */
+  void failNext(uint32_t count, uint32_t after = 0) {
+    m_failures = count;
+    m_failAfter = after;
+  }
+
+  /*!
+      @brief  Takes the chip off the bus, or puts it back
+      @param present false to fail every transaction
+  */
+  void setPresent(bool present) { m_present = present; }
+
+  /*!
+      @brief  Overwrites the conversion register, e.g. with a raw value
+      @param raw the register value
+  */
+  void setConversion(uint16_t raw) {
+    m_regs[ADS1X15_REG_POINTER_CONVERT] = raw;
+  }
+
+  /*!
+      @brief  Gets a register as the chip holds it
+      @param reg register pointer
+      @return the register value
+  */
+  uint16_t reg(uint8_t reg) {
+    advance();
+    return m_regs[reg & ADS1X15_REG_POINTER_MASK];
+  }
+
+  /*!
+      @brief  Checks the comparator output, whatever the pin polarity
+      @return true while ALERT/RDY is asserted by the comparator
+  */
+  bool alert() {
+    advance();
+    return m_alert;
+  }
+
+  bool begin() override {
+    begins++;
+    m_begun = true;
+    return m_present;
+  }
+
+  void end() override {
+    ends++;
+    m_begun = false;
+  }
+
+  bool write(const uint8_t *buffer, size_t len) override {
+    writes++;
+    if (!transact()) {
+      return false;
+    }
+    bytes += len;
+    m_pointer = buffer[0] & ADS1X15_REG_POINTER_MASK;
+    if (len >= 3) {
+      writeRegister(m_pointer, (buffer[1] << 8) | buffer[2]);
+    }
+    return true;
+  }
+
+  bool read(uint8_t *buffer, size_t len) override {
+    reads++;
+    if (!transact()) {
+      return false;
+    }
+    bytes += len;
+    uint16_t value = readRegister(m_pointer);
+    buffer[0] = value >> 8;
+    if (len > 1) {
+      buffer[1] = value & 0xFF;
+    }
+    return true;
+  }
+
+  bool writeThenRead(const uint8_t *out, size_t outLen, uint8_t *in,
+                     size_t inLen) override {
+    combined++;
+    if (!transact()) {
+      return false;
+    }
+    bytes += outLen + inLen;
+    m_pointer = out[0] & ADS1X15_REG_POINTER_MASK;
+    uint16_t value = readRegister(m_pointer);
+    in[0] = value >> 8;
+    if (inLen > 1) {
+      in[1] = value & 0xFF;
+    }
+    return true;
+  }
+
+  uint32_t writes;      ///< write() calls
+  uint32_t reads;       ///< read() calls
+  uint32_t combined;    ///< writeThenRead() calls
+  uint32_t bytes;       ///< Bytes moved by successful transactions
+  uint32_t begins;      ///< begin() calls
+  uint32_t ends;        ///< end() calls
+  uint32_t readyPulses; ///< Conversions signalled in RDY mode
+
+private:
+  /*!
+      @brief  Starts a transaction
+      @return false if it fails
+  */
+  bool transact() {
+    advance();
+    if (!m_present || !m_begun) {
+      return false;
+    }
+    if (m_failures > 0) {
+      if (m_failAfter > 0) {
+        m_failAfter--;
+        return true;
+      }
+      m_failures--;
+      return false;
+    }
+    return true;
+  }
+
+  /*!
+      @brief  Gets the conversion time at the configured data rate
+      @return the time in microseconds, scaled by setTiming()
+  */
+  uint32_t period() {
+    uint16_t rate = m_regs[ADS1X15_REG_POINTER_CONFIG];
+    uint16_t hz = (m_bits == 12) ? ADS1015_Traits::sps(rate)
+                                 : ADS1115_Traits::sps(rate);
+    return (uint32_t)((1000000ULL * m_percent) / (100ULL * hz));
+  }
+
+  /*!
+      @brief  Handles a register write
+      @param reg register pointer
+      @param value value written
+  */
+  void writeRegister(uint8_t reg, uint16_t value) {
+    if (reg == ADS1X15_REG_POINTER_CONVERT) {
+      return; // read only
+    }
+    if (reg != ADS1X15_REG_POINTER_CONFIG) {
+      m_regs[reg] = value;
+      return;
+    }
+
+    // The OS bit reads back as the conversion status
+    m_regs[reg] = value & ~ADS1X15_REG_CONFIG_OS_MASK;
+    m_single = false;
+    m_continuous = false;
+    m_beyond = 0;
+    if ((value & ADS1X15_REG_CONFIG_CQUE_MASK) ==
+        ADS1X15_REG_CONFIG_CQUE_NONE) {
+      m_alert = false;
+    }
+    m_start = micros();
+    m_done = 0;
+    if ((value & ADS1X15_REG_CONFIG_MODE_MASK) ==
+        ADS1X15_REG_CONFIG_MODE_CONTIN) {
+      m_continuous = true;
+    } else if (value & ADS1X15_REG_CONFIG_OS_MASK) {
+      m_single = true;
+    }
+  }
+
+  /*!
+      @brief  Handles a register read
+      @param reg register pointer
+      @return the register value
+  */
+  uint16_t readRegister(uint8_t reg) {
+    uint16_t value = m_regs[reg];
+    if (reg == ADS1X15_REG_POINTER_CONFIG && !m_single && !m_continuous) {
+      value |= ADS1X15_REG_CONFIG_OS_NOTBUSY;
+    }
+    if (reg == ADS1X15_REG_POINTER_CONVERT &&
+        (m_regs[ADS1X15_REG_POINTER_CONFIG] & ADS1X15_REG_CONFIG_CLAT_MASK)) {
+      // Reading the conversion register clears a latched alert
+      m_alert = false;
+    }
+    return value;
+  }
+
+  /*!
+      @brief  Finishes the conversions that are due by now
+  */
+  void advance() {
+    uint32_t elapsed = micros() - m_start;
+    uint32_t t = period();
+    if (m_single) {
+      if (elapsed >= t) {
+        m_single = false;
+        convert();
+      }
+    } else if (m_continuous) {
+      // With zero timing every transaction sees one new conversion
+      uint32_t due = (t == 0) ? m_done + 1 : elapsed / t;
+      while (m_done < due) {
+        m_done++;
+        convert();
+      }
+    }
+  }
+
+  /*!
+      @brief  Converts the selected input and runs the comparator
+  */
+  void convert() {
+    static const float fsRange[] = {6.144f, 4.096f, 2.048f, 1.024f,
+                                    0.512f, 0.256f, 0.256f, 0.256f};
+    uint16_t config = m_regs[ADS1X15_REG_POINTER_CONFIG];
+    float volts = m_inputs[(config & ADS1X15_REG_CONFIG_MUX_MASK) >> 12];
+    float fs = fsRange[(config & ADS1X15_REG_CONFIG_PGA_MASK) >> 9];
+    float code = volts / fs * 32768.0f;
+    int32_t counts = (int32_t)((code < 0) ? code - 0.5f : code + 0.5f);
+    if (counts > 32767) {
+      counts = 32767;
+    } else if (counts < -32768) {
+      counts = -32768;
+    }
+    if (m_bits == 12) {
+      counts &= ~0x0F; // 12-bit results are left aligned
+    }
+    m_regs[ADS1X15_REG_POINTER_CONVERT] = (uint16_t)counts;
+    compare((int16_t)counts, config);
+  }
+
+  /*!
+      @brief  Updates ALERT/RDY for a new conversion, see data sheet 9.3.8
+      @param counts the conversion result
+      @param config config register
+  */
+  void compare(int16_t counts, uint16_t config) {
+    uint8_t queue = config & ADS1X15_REG_CONFIG_CQUE_MASK;
+    if (queue == ADS1X15_REG_CONFIG_CQUE_NONE) {
+      return;
+    }
+    int16_t lo = (int16_t)m_regs[ADS1X15_REG_POINTER_LOWTHRESH];
+    int16_t hi = (int16_t)m_regs[ADS1X15_REG_POINTER_HITHRESH];
+    if ((hi & 0x8000) && !(lo & 0x8000)) {
+      // RDY mode, a pulse per conversion
+      readyPulses++;
+      return;
+    }
+
+    bool window = (config & ADS1X15_REG_CONFIG_CMODE_MASK) ==
+                  ADS1X15_REG_CONFIG_CMODE_WINDOW;
+    bool latch = config & ADS1X15_REG_CONFIG_CLAT_MASK;
+    bool beyond = (counts > hi) || (window && counts < lo);
+    m_beyond = beyond ? m_beyond + 1 : 0;
+    if (m_beyond >= (1 << queue)) {
+      m_alert = true;
+    } else if (!latch && (window ? !beyond : counts < lo)) {
+      m_alert = false;
+    }
+  }
+
+  uint8_t m_bits;        ///< 12 or 16
+  uint16_t m_regs[4];    ///< Register file
+  uint8_t m_pointer;     ///< Pointer register
+  float m_inputs[8];     ///< Input voltage per mux setting
+  uint16_t m_percent;    ///< Conversion time, % of nominal
+  uint32_t m_failures;   ///< Transactions left to fail
+  uint32_t m_failAfter;  ///< Transactions to pass before failing
+  bool m_present;        ///< Acknowledges its address
+  bool m_begun;          ///< Bus is between begin() and end()
+  bool m_single;         ///< Single-shot conversion running
+  bool m_continuous;     ///< Continuous conversions running
+  uint32_t m_start;      ///< micros() when conversions started
+  uint32_t m_done;       ///< Continuous conversions finished
+  bool m_alert;          ///< Comparator output
+  uint8_t m_beyond;      ///< Conversions in a row beyond the threshold
+};
+
+#endif
@@ -0,0 +1,159 @@
+/**************************************************************************/
+/*!
+    @file     benchmark.cpp
+
+    Host version of examples/benchmark: drives the driver's read paths
+    through Adafruit_ADS1X15_CountingTransport over FakeADS1X15 and prints
+    what each costs on the bus as CSV, so a driver change can be checked
+    for extra bus traffic without hardware. Conversions finish straight
+    away, so the counts are the same on every run:
+
+      call,<name>,<transactions>,<starts>,<bytes>,<bus_us_100k>,
+           <bus_us_400k>,<bus_us_3m4>
+
+    Counts and bus times are per call, or per sample for the burst, scan
+    and stream rows. Wall-clock times depend on the real bus; see the
+    example sketch for those.
+
+    BSD license, all text here must be included in any redistribution
+*/
+/**************************************************************************/
+#include "Adafruit_ADS1X15.h"
+#include "Adafruit_ADS1X15_Scan.h"
+#include "Adafruit_ADS1X15_Stream.h"
+#include "ads1x15_fake.h"
+
+#include <stdio.h>
+
+/** Calls averaged per row */
+#define ITERATIONS (50)
+
+/** Bus clocks the bus time is modelled at */
+static const uint32_t MODELLED[] = {100000, 400000, 3400000};
+
+static FakeADS1X15 chip(16);
+static Adafruit_ADS1X15_CountingTransport bus(&chip);
+static Adafruit_ADS1115 ads;
+
+/** Set if any read in a row failed, which makes its counts meaningless */
+static bool failed;
+
+/*!
+    @brief  Prints one CSV row
+    @param name what was measured
+    @param n calls or samples the counts are divided by
+*/
+static void printRow(const char *name, uint32_t n) {
+  printf("call,%s,%.2f,%.2f,%.2f", name, (float)bus.transactions() / n,
+         (float)bus.starts() / n, (float)bus.bytes() / n);
+  for (uint32_t clock : MODELLED) {
+    printf(",%.2f", bus.busMicros(clock) / n);
+  }
+  printf("\n");
+}
+
+/*!
+    @brief  Measures a driver call, after one call to warm the register
+            cache, so each row shows the steady-state cost
+    @param name what was measured
+    @param func the call
+*/
+static void benchCall(const char *name, void (*func)()) {
+  func();
+  bus.reset();
+  for (uint16_t i = 0; i < ITERATIONS; i++) {
+    func();
+  }
+  printRow(name, ITERATIONS);
+}
+
+/** Readings for the burst, scan and stream rows */
+static int16_t results[ITERATIONS];
+
+static void benchBurst() {
+  ads.readBurst(MUX_BY_CHANNEL[0], results, ITERATIONS);
+  bus.reset();
+  size_t n = ads.readBurst(MUX_BY_CHANNEL[0], results, ITERATIONS);
+  failed |= (n != ITERATIONS);
+  printRow("readBurst", ITERATIONS);
+}
+
+static void benchScan() {
+  static const adsScanEntry_t sweep[] = {{MUX_BY_CHANNEL[0], GAIN_ONE},
+                                         {MUX_BY_CHANNEL[1], GAIN_ONE},
+                                         {MUX_BY_CHANNEL[2], GAIN_ONE},
+                                         {MUX_BY_CHANNEL[3], GAIN_ONE}};
+  Adafruit_ADS1X15_Scan scan(&ads);
+  scan.start(sweep, 4, results);
+  scan.update(/*dataReady=*/true);
+  bus.reset();
+  for (uint16_t i = 0; i < ITERATIONS; i++) {
+    scan.update(/*dataReady=*/true);
+  }
+  scan.stop();
+  failed |= (scan.getErrors() != 0);
+  printRow("scan", ITERATIONS);
+}
+
+static void benchStream() {
+  adsSample_t buffer[4];
+  Adafruit_ADS1X15_Stream stream(&ads);
+  stream.start(MUX_BY_CHANNEL[0], buffer, 4);
+  bus.reset();
+  for (uint16_t i = 0; i < ITERATIONS; i++) {
+    ads.dataReadyISR();
+    stream.service();
+    stream.read(buffer, 4);
+  }
+  printRow("stream", ITERATIONS);
+  stream.stop();
+  failed |= (stream.getErrors() != 0);
+}
+
+int main() {
+  chip.setTiming(0);
+  for (uint8_t channel = 0; channel < 4; channel++) {
+    chip.setInput(MUX_BY_CHANNEL[channel], 0.5f * channel);
+  }
+  if (!ads.begin(&bus)) {
+    fprintf(stderr, "begin failed\n");
+    return 1;
+  }
+  ads.setDataRate(ADS1115_RATE_860SPS);
+
+  printf("call,name,transactions,starts,bytes,bus_us_100k,bus_us_400k,"
+         "bus_us_3m4\n");
+  benchCall("readADC_SingleEnded", [] { ads.readADC_SingleEnded(0); });
+  benchCall("readADC", [] {
+    int16_t counts;
+    failed |= (ads.readADC(MUX_BY_CHANNEL[1], &counts) != ADS1X15_OK);
+  });
+  benchCall("readADC_Differential_0_1", [] { ads.readADC_Differential_0_1(); });
+  benchCall("readADC_AutoRange", [] {
+    float volts;
+    failed |= (ads.readADC_AutoRange(MUX_BY_CHANNEL[2], &volts) !=
+               ADS1X15_OK);
+  });
+  benchCall("startADCReading",
+            [] { ads.startADCReading(MUX_BY_CHANNEL[0], false); });
+  benchCall("conversionComplete", [] { ads.conversionComplete(); });
+  benchCall("getLastConversionResults",
+            [] { ads.getLastConversionResults(); });
+  benchCall("async", [] {
+    adsConversion_t conv;
+    ads.startAsync(&conv, MUX_BY_CHANNEL[3]);
+    failed |= (ads.pollAsync(&conv, /*dataReady=*/true) !=
+               ADS1X15_CONV_DONE);
+  });
+  benchCall("startComparator_SingleEnded",
+            [] { ads.startComparator_SingleEnded(0, 1000); });
+  benchBurst();
+  benchScan();
+  benchStream();
+
+  if (failed) {
+    fprintf(stderr, "a read failed, the counts are not comparable\n");
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,70 @@
+/**************************************************************************/
+/*!
+    @file     test.h
+
+    Minimal checks for the ADS1X15 host tests. Each test is a function
+    run by RUN(); a failed check is printed and the test carries on.
+
+    BSD license, all text here must be included in any redistribution
+*/
+/**************************************************************************/
+#ifndef __ADS1X15_TEST_H__
+#define __ADS1X15_TEST_H__
+
+#include <math.h>
+#include <stdio.h>
+
+static int testFailures = 0; ///< Failed checks so far
+
+/** Fails the test if cond is false */
+#define CHECK(cond)                                                            \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      testFailures++;                                                          \
+      printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond);          \
+    }                                                                          \
+  } while (0)
+
+/** Fails the test if two integers differ */
+#define CHECK_EQ(a, b)                                                         \
+  do {                                                                         \
+    long long a_ = (long long)(a), b_ = (long long)(b);                        \
+    if (a_ != b_) {                                                            \
+      testFailures++;                                                          \
+      printf("%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", __FILE__,       \
+             __LINE__, #a, #b, a_, b_);                                        \
+    }                                                                          \
+  } while (0)
+
+/** Fails the test if two floats are further apart than tol */
+#define CHECK_NEAR(a, b, tol)                                                  \
+  do {                                                                         \
+    double a_ = (a), b_ = (b);                                                 \
+    if (fabs(a_ - b_) > (tol)) {                                               \
+      testFailures++;                                                          \
+      printf("%s:%d: CHECK_NEAR(%s, %s) failed: %g != %g\n", __FILE__,         \
+             __LINE__, #a, #b, a_, b_);                                        \
+    }                                                                          \
+  } while (0)
+
+/** Runs one test function */
+#define RUN(test)                                                              \
+  do {                                                                         \
+    printf("%s\n", #test);                                                     \
+    test();                                                                    \
+  } while (0)
+
+/*!
+    @brief  Reports the outcome of the tests run so far
+    @return exit status for main()
+*/
+static inline int testResult() {
+  if (testFailures != 0) {
+    printf("%d check(s) failed\n", testFailures);
+    return 1;
+  }
+  printf("all checks passed\n");
+  return 0;
+}
+
+#endif
@@ -0,0 +1,935 @@
+/**************************************************************************/
+/*!
+    @file     test_driver.cpp
+
+    Host tests for the ADS1X15 driver, run against FakeADS1X15 in place of
+    the chip. Build and run with CMake from this directory:
+
+      cmake -S tests -B build/tests && cmake --build build/tests
+      ctest --test-dir build/tests --output-on-failure
+
+    BSD license, all text here must be included in any redistribution
+*/
+/**************************************************************************/
+#include "Adafruit_ADS1X15.h"
+#include "Adafruit_ADS1X15_Group.h"
+#include "Adafruit_ADS1X15_Scan.h"
+#include "Adafruit_ADS1X15_Stream.h"
+#include "ads1x15_fake.h"
+#include "test.h"
+
+/** Full-scale range in volts per gain setting, see data sheet Table 3 */
+static const struct {
+  adsGain_t gain;
+  float fsRange;
+} GAINS[] = {{GAIN_TWOTHIRDS, 6.144f}, {GAIN_ONE, 4.096f},
+             {GAIN_TWO, 2.048f},       {GAIN_FOUR, 1.024f},
+             {GAIN_EIGHT, 0.512f},     {GAIN_SIXTEEN, 0.256f}};
+
+/*!
+    @brief  Gets the input voltage that converts to a 16-bit count
+    @param counts 16-bit conversion result
+    @param fsRange full-scale range in volts
+    @return the voltage
+*/
+static float volts(int32_t counts, float fsRange) {
+  return counts * fsRange / 32768.0f;
+}
+
+/*!
+    @brief  Begins an ADS1115 on the fake at its fastest data rate
+    @param ads driver
+    @param chip fake chip
+*/
+static void start(Adafruit_ADS1115 &ads, FakeADS1X15 &chip) {
+  CHECK(ads.begin(&chip));
+  ads.setDataRate(ADS1115_RATE_860SPS);
+}
+
+/*!
+    @brief  Begins an ADS1015 on the fake at its fastest data rate
+    @param ads driver
+    @param chip fake chip
+*/
+static void start(Adafruit_ADS1015 &ads, FakeADS1X15 &chip) {
+  CHECK(ads.begin(&chip));
+  ads.setDataRate(ADS1015_RATE_3300SPS);
+}
+
+static void testSignExtension1015() {
+  FakeADS1X15 chip(12);
+  Adafruit_ADS1015 ads;
+  Adafruit_ADS1X15 &base = ads;
+  start(ads, chip);
+
+  chip.setConversion(0x7FF0);
+  CHECK_EQ(ads.getLastConversionResults(), 2047);
+  chip.setConversion(0x8000);
+  CHECK_EQ(ads.getLastConversionResults(), -2048);
+  chip.setConversion(0xFFF0);
+  CHECK_EQ(ads.getLastConversionResults(), -1);
+  CHECK_EQ(base.getLastConversionResults(), -1);
+  chip.setConversion(0x0010);
+  CHECK_EQ(base.getLastConversionResults(), 1);
+
+  int16_t counts;
+  chip.setConversion(0x8010);
+  CHECK_EQ(ads.getLastConversionResults(&counts), ADS1X15_OK);
+  CHECK_EQ(counts, -2047);
+}
+
+static void testSignExtension1115() {
+  FakeADS1X15 chip(16);
+  Adafruit_ADS1115 ads;
+  start(ads, chip);
+
+  chip.setConversion(0x7FFF);
+  CHECK_EQ(ads.getLastConversionResults(), 32767);
+  chip.setConversion(0x8000);
+  CHECK_EQ(ads.getLastConversionResults(), -32768);
+  chip.setConversion(0xFFFF);
+  CHECK_EQ(ads.getLastConversionResults(), -1);
+  chip.setConversion(0x0001);
+  CHECK_EQ(ads.getLastConversionResults(), 1);
+}
+
+static void testComputeVolts() {
+  Adafruit_ADS1015 ads1015;
+  Adafruit_ADS1115 ads1115;
+  for (size_t i = 0; i < sizeof(GAINS) / sizeof(GAINS[0]); i++) {
+    adsGain_t gain = GAINS[i].gain;
+    float half = GAINS[i].fsRange / 2;
+    int32_t halfMicrovolts = (int32_t)lroundf(half * 1e6f);
+
+    // Half of full scale at either resolution
+    CHECK_NEAR(ads1115.computeVolts(16384, gain), half, 1e-6);
+    CHECK_NEAR(ads1115.computeVolts(-16384, gain), -half, 1e-6);
+    CHECK_NEAR(ads1015.computeVolts(1024, gain), half, 1e-6);
+    CHECK_NEAR(ads1015.computeVolts(-1024, gain), -half, 1e-6);
+    CHECK_EQ(ads1115.computeMicrovolts(16384, gain), halfMicrovolts);
+    CHECK_EQ(ads1015.computeMicrovolts(1024, gain), halfMicrovolts);
+    CHECK_EQ(ads1115.computeMicrovolts(-16384, gain), -halfMicrovolts);
+
+    // The current-gain paths agree with the explicit-gain ones
+    ads1115.setGain(gain);
+    ads1015.setGain(gain);
+    CHECK_EQ(ads1115.getGain(), gain);
+    CHECK_NEAR(ads1115.computeVolts(12345), ads1115.computeVolts(12345, gain),
+               1e-6);
+    CHECK_NEAR(ads1015.computeVolts(-777), ads1015.computeVolts(-777, gain),
+               1e-6);
+    CHECK_EQ(ads1115.computeMicrovolts(-12345),
+             ads1115.computeMicrovolts(-12345, gain));
+    CHECK_EQ(ads1115.computeCounts(ads1115.computeVolts(12345)), 12345);
+    CHECK_EQ(ads1015.computeCounts(ads1015.computeVolts(-777)), -777);
+
+    int16_t counts[3] = {-32768, 0, 32767};
+    float v[3];
+    int32_t uv[3];
+    ads1115.computeVolts(counts, v, 3);
+    ads1115.computeMicrovolts(counts, uv, 3);
+    for (uint8_t j = 0; j < 3; j++) {
+      CHECK_NEAR(v[j], ads1115.computeVolts(counts[j], gain), 1e-6);
+      CHECK_EQ(uv[j], ads1115.computeMicrovolts(counts[j], gain));
+    }
+  }
+
+  // Out of range voltages clamp to the ADC's range
+  ads1015.setGain(GAIN_ONE);
+  CHECK_EQ(ads1015.computeCounts(10.0f), 2047);
+  CHECK_EQ(ads1015.computeCounts(-10.0f), -2048);
+}
+
+static void testSingleEnded() {
+  static const int16_t inputs[] = {100, 200, 3000, 4000};
+  FakeADS1X15 chip(16);
+  Adafruit_ADS1115 ads;
+  start(ads, chip);
+  ads.setGain(GAIN_ONE);
+  for (uint8_t ch = 0; ch < 4; ch++) {
+    chip.setInput(MUX_BY_CHANNEL[ch], volts(inputs[ch], 4.096f));
+  }
+
+  for (uint8_t ch = 0; ch < 4; ch++) {
+    CHECK_EQ(ads.readADC_SingleEnded(ch), inputs[ch]);
+    uint16_t config = chip.reg(ADS1X15_REG_POINTER_CONFIG);
+    CHECK_EQ(config & ADS1X15_REG_CONFIG_MUX_MASK, MUX_BY_CHANNEL[ch]);
+    CHECK_EQ(config & ADS1X15_REG_CONFIG_MODE_MASK,
+             ADS1X15_REG_CONFIG_MODE_SINGLE);
+    CHECK_EQ(config & ADS1X15_REG_CONFIG_PGA_MASK, GAIN_ONE);
+    CHECK_EQ(config & ADS1X15_REG_CONFIG_RATE_MASK, RATE_ADS1115_860SPS);
+  }
+
+  int16_t counts = 1;
+  CHECK_EQ(ads.readADC_SingleEnded(4, &counts), ADS1X15_ERR_ARGUMENT);
+  CHECK_EQ(counts, 0);
+  CHECK_EQ(ads.getStatus(), ADS1X15_ERR_ARGUMENT);
+}
+
+static void testDifferential() {
+  FakeADS1X15 chip(16);
+  Adafruit_ADS1115 ads;
+  start(ads, chip);
+  chip.setInput(ADS1X15_REG_CONFIG_MUX_DIFF_0_1, volts(-2400, 6.144f));
+  chip.setInput(ADS1X15_REG_CONFIG_MUX_DIFF_0_3, volts(1200, 6.144f));
+  chip.setInput(ADS1X15_REG_CONFIG_MUX_DIFF_1_3, volts(-600, 6.144f));
+  chip.setInput(ADS1X15_REG_CONFIG_MUX_DIFF_2_3, volts(300, 6.144f));
+
+  CHECK_EQ(ads.readADC_Differential_0_1(), -2400);
+  CHECK_EQ(chip.reg(ADS1X15_REG_POINTER_CONFIG) & ADS1X15_REG_CONFIG_MUX_MASK,
+           ADS1X15_REG_CONFIG_MUX_DIFF_0_1);
+  CHECK_EQ(ads.readADC_Differential_0_3(), 1200);
+  CHECK_EQ(ads.readADC_Differential_1_3(), -600);
+  CHECK_EQ(ads.readADC_Differential_2_3(), 300);
+  CHECK_EQ(chip.reg(ADS1X15_REG_POINTER_CONFIG) & ADS1X15_REG_CONFIG_MUX_MASK,
+           ADS1X15_REG_CONFIG_MUX_DIFF_2_3);
+
+  // 12-bit results are the top 12 bits of the same reading
+  FakeADS1X15 chip1015(12);
+  Adafruit_ADS1015 ads1015;
+  start(ads1015, chip1015);
+  chip1015.setInput(ADS1X15_REG_CONFIG_MUX_DIFF_0_1, volts(-3200, 6.144f));
+  chip1015.setInput(MUX_BY_CHANNEL[0], volts(1600, 6.144f));
+  CHECK_EQ(ads1015.readADC_Differential_0_1(), -200);
+  CHECK_EQ(ads1015.readADC_SingleEnded(0), 100);
+}
+
+static void testContinuous() {
+  FakeADS1X15 chip(16);
+  Adafruit_ADS1115 ads;
+  start(ads, chip);
+  chip.setInput(MUX_BY_CHANNEL[2], volts(3000, 6.144f));
+  chip.setInput(MUX_BY_CHANNEL[3], volts(4000, 6.144f));
+
+  ads.startADCReading(MUX_BY_CHANNEL[2], /*continuous=*/true);
+  uint16_t config = chip.reg(ADS1X15_REG_POINTER_CONFIG);
+  CHECK_EQ(config & ADS1X15_REG_CONFIG_MODE_MASK,
+           ADS1X15_REG_CONFIG_MODE_CONTIN);
+  // ALERT/RDY is in RDY mode, pulsing once per conversion
+  CHECK_EQ(chip.reg(ADS1X15_REG_POINTER_HITHRESH), 0x8000);
+  CHECK_EQ(chip.reg(ADS1X15_REG_POINTER_LOWTHRESH), 0x0000);
+  delay(5);
+  CHECK_EQ(ads.getLastConversionResults(), 3000);
+  CHECK(chip.readyPulses >= 2);
+
+  int16_t burst[4] = {0, 0, 0, 0};
+  CHECK_EQ(ads.readBurst(MUX_BY_CHANNEL[3], burst, 4), 4);
+  for (uint8_t i = 0; i < 4; i++) {
+    CHECK_EQ(burst[i], 4000);
+  }
+  // The burst leaves the chip powered down
+  config = chip.reg(ADS1X15_REG_POINTER_CONFIG);
+  CHECK_EQ(config & ADS1X15_REG_CONFIG_MODE_MASK,
+           ADS1X15_REG_CONFIG_MODE_SINGLE);
+  CHECK(ads.conversionComplete());
+}
+
+static void testSingleShot() {
+  FakeADS1X15 chip(16);
+  Adafruit_ADS1115 ads;
+  start(ads, chip);
+  chip.setInput(MUX_BY_CHANNEL[1], volts(-1234, 6.144f));
+
+  ads.startADCReading(MUX_BY_CHANNEL[1], /*continuous=*/false);
+  CHECK(!ads.conversionComplete());
+  CHECK(ads.waitForConversion());
+  CHECK(ads.conversionComplete());
+  CHECK(!ads.conversionTimedOut());
+  CHECK_EQ(ads.getLastConversionResults(), -1234);
+}
+
+static void testComparator() {
+  FakeADS1X15 chip(16);
+  Adafruit_ADS1115 ads;
+  start(ads, chip);
+
+  ads.startComparator_SingleEnded(0, 1000);
+  CHECK_EQ(chip.reg(ADS1X15_REG_POINTER_HITHRESH), 1000);
+  uint16_t config = chip.reg(ADS1X15_REG_POINTER_CONFIG);
+  CHECK_EQ(config & ADS1X15_REG_CONFIG_MUX_MASK, MUX_BY_CHANNEL[0]);
+  CHECK_EQ(config & ADS1X15_REG_CONFIG_MODE_MASK,
+           ADS1X15_REG_CONFIG_MODE_CONTIN);
+  CHECK_EQ(config & ADS1X15_REG_CONFIG_CLAT_MASK,
+           ADS1X15_REG_CONFIG_CLAT_LATCH);
+  CHECK_EQ(config & ADS1X15_REG_CONFIG_CQUE_MASK,
+           ADS1X15_REG_CONFIG_CQUE_1CONV);
+
+  chip.setInput(MUX_BY_CHANNEL[0], volts(2000, 6.144f));
+  delay(5);
+  CHECK(chip.alert());
+
+  // Latched until the conversion register is read
+  chip.setInput(MUX_BY_CHANNEL[0], 0);
+  delay(5);
+  CHECK(chip.alert());
+  CHECK_EQ(ads.getLastConversionResults(), 0);
+  delay(5);
+  CHECK(!chip.alert());
+
+  // The next reading starts RDY mode again
+  ads.readADC_SingleEnded(0);
+  CHECK_EQ(chip.reg(ADS1X15_REG_POINTER_HITHRESH), 0x8000);
+
+  // ADS1015 thresholds are left aligned like its results
+  FakeADS1X15 chip1015(12);
+  Adafruit_ADS1015 ads1015;
+  start(ads1015, chip1015);
+  ads1015.startComparator_SingleEnded(1, 100);
+  CHECK_EQ(chip1015.reg(ADS1X15_REG_POINTER_HITHRESH), 1600);
+  CHECK(!ads1015.startComparator(MUX_BY_CHANNEL[0], 0, 2048));
+}
+
+static void testWindowComparator() {
+  FakeADS1X15 chip(16);
+  Adafruit_ADS1115 ads;
+  start(ads, chip);
+  uint16_t mux = MUX_BY_CHANNEL[1];
+
+  CHECK(!ads.startComparator(mux, 500, -500));
+  CHECK(!ads.startComparator(mux, -500, 500, ADS1X15_REG_CONFIG_CMODE_WINDOW,
+                             ADS1X15_REG_CONFIG_CPOL_ACTVLOW,
+                             ADS1X15_REG_CONFIG_CLAT_NONLAT,
+                             ADS1X15_REG_CONFIG_CQUE_NONE));
+  CHECK(ads.startComparator(mux, -500, 500, ADS1X15_REG_CONFIG_CMODE_WINDOW,
+                            ADS1X15_REG_CONFIG_CPOL_ACTVLOW,
+                            ADS1X15_REG_CONFIG_CLAT_NONLAT));
+  CHECK_EQ((int16_t)chip.reg(ADS1X15_REG_POINTER_LOWTHRESH), -500);
+  CHECK_EQ(chip.reg(ADS1X15_REG_POINTER_HITHRESH), 500);
+
+  delay(5);
+  CHECK(!chip.alert());
+  chip.setInput(mux, volts(1000, 6.144f));
+  delay(5);
+  CHECK(chip.alert());
+  chip.setInput(mux, volts(-1000, 6.144f));
+  delay(5);
+  CHECK(chip.alert());
+  chip.setInput(mux, 0);
+  delay(5);
+  CHECK(!chip.alert());
+}
+
+static void testTimeout() {
+  FakeADS1X15 chip(16);
+  Adafruit_ADS1115 ads;
+  start(ads, chip);
+  chip.setTiming(1000);
+
+  int16_t counts = 1;
+  ads.setConversionTimeout(1);
+  CHECK_EQ(ads.readADC(MUX_BY_CHANNEL[0], &counts), ADS1X15_ERR_TIMEOUT);
+  CHECK_EQ(counts, 0);
+  CHECK(ads.conversionTimedOut());
+  CHECK_EQ(ads.getRecoveries(), 0);
+
+  // The watchdog gives up by the slowest the oscillator can run, well
+  // before the timeout, then recovers the chip
+  ads.setConversionTimeout(250);
+  ads.setWatchdog(true);
+  uint32_t begins = chip.begins;
+  uint32_t start = millis();
+  CHECK_EQ(ads.readADC(MUX_BY_CHANNEL[0], &counts), ADS1X15_ERR_TIMEOUT);
+  CHECK(millis() - start < 50);
+  CHECK_EQ(ads.getRecoveries(), 1);
+  CHECK_EQ(chip.ends, 1);
+  CHECK_EQ(chip.begins, begins + 1);
+
+  // The bus is ended, then begun again before the registers are restored.
+  // The fake refuses transactions in between, so this fails otherwise.
+  CHECK(ads.recover());
+  CHECK_EQ(chip.ends, 2);
+
+  chip.setTiming(100);
+  CHECK_EQ(ads.readADC(MUX_BY_CHANNEL[0], &counts), ADS1X15_OK);
+  CHECK_EQ(ads.getConsecutiveFailures(), 0);
+}
+
+static void testRecoverBeforeBegin() {
+  Adafruit_ADS1115 ads;
+  CHECK(!ads.recover());
+  CHECK_EQ(ads.getRecoveries(), 0);
+  CHECK_EQ(ads.getSavedTransactions(), 0);
+}
+
+static void testBusErrors() {
+  FakeADS1X15 chip(16);
+  Adafruit_ADS1115 ads;
+  start(ads, chip);
+  chip.setInput(MUX_BY_CHANNEL[0], volts(100, 6.144f));
+
+  int16_t counts = 1;
+  chip.failNext(1);
+  CHECK_EQ(ads.readADC(MUX_BY_CHANNEL[0], &counts), ADS1X15_ERR_BUS);
+  CHECK_EQ(counts, 0);
+  CHECK_EQ(ads.readADC(MUX_BY_CHANNEL[0], &counts), ADS1X15_OK);
+  CHECK_EQ(counts, 100);
+
+  // A failed read returns 0, not what was left in the buffer
+  chip.failNext(1);
+  CHECK_EQ(ads.getLastConversionResults(&counts), ADS1X15_ERR_BUS);
+  CHECK_EQ(counts, 0);
+
+  // Enough failures in a row open the breaker, which keeps off the bus
+  ads.setCircuitBreaker(2, 50);
+  chip.setPresent(false);
+  CHECK_EQ(ads.readADC(MUX_BY_CHANNEL[0], &counts), ADS1X15_ERR_BUS);
+  CHECK(ads.circuitOpen());
+  uint32_t transactions = chip.writes + chip.reads + chip.combined;
+  CHECK_EQ(ads.readADC(MUX_BY_CHANNEL[0], &counts), ADS1X15_ERR_OFFLINE);
+  CHECK_EQ(chip.writes + chip.reads + chip.combined, transactions);
+
+  // Once it cools down, the next read recovers the chip
+  chip.setPresent(true);
+  chip.powerOn();
+  delay(60);
+  CHECK_EQ(ads.readADC(MUX_BY_CHANNEL[0], &counts), ADS1X15_OK);
+  CHECK_EQ(counts, 100);
+  CHECK(!ads.circuitOpen());
+  CHECK_EQ(ads.getRecoveries(), 1);
+}
+
+static void testRegisterCache() {
+  FakeADS1X15 chip(16);
+  Adafruit_ADS1115 ads;
+  start(ads, chip);
+
+  int16_t counts;
+  ads.readADC(MUX_BY_CHANNEL[0], &counts);
+  // Config, then the RDY mode thresholds the first time only
+  CHECK_EQ(chip.writes, 3);
+  uint32_t writes = chip.writes;
+  uint32_t combined = chip.combined;
+  uint32_t saved = ads.getSavedTransactions();
+  ads.readADC(MUX_BY_CHANNEL[0], &counts);
+  CHECK_EQ(chip.writes - writes, 1);
+  // Polling reads the config register the write just pointed at
+  CHECK(chip.reads >= 1);
+  // Only the conversion read moves the pointer
+  CHECK_EQ(chip.combined - combined, 1);
+  CHECK(ads.getSavedTransactions() >= saved + 3);
+
+  // begin() forgets the cache, the chip may have reset
+  CHECK(ads.begin(&chip));
+  writes = chip.writes;
+  ads.readADC(MUX_BY_CHANNEL[0], &counts);
+  CHECK_EQ(chip.writes - writes, 3);
+}
+
+static void testCountingTransport() {
+  FakeADS1X15 chip(16);
+  Adafruit_ADS1X15_CountingTransport bus(&chip);
+  uint8_t config[3] = {ADS1X15_REG_POINTER_CONFIG, 0x85, 0x83};
+  uint8_t pointer = ADS1X15_REG_POINTER_CONVERT;
+  uint8_t in[2];
+
+  CHECK(bus.write(config, 3));
+  CHECK(bus.writeThenRead(&pointer, 1, in, 2));
+  CHECK_EQ(bus.transactions(), 2);
+  CHECK_EQ(bus.starts(), 3);
+  CHECK_EQ(bus.bytes(), 6);
+  CHECK_EQ(chip.writes, 1);
+  CHECK_EQ(chip.combined, 1);
+  // 3 STARTs with their address bytes, 6 data bytes, 2 STOPs
+  CHECK_NEAR(bus.busMicros(100000), 860, 1e-3);
+  CHECK_NEAR(bus.busMicros(400000), 215, 1e-3);
+  CHECK_NEAR(bus.busMicros(3400000), 86 / 3.4 + 2 * 25, 1e-3);
+
+  chip.failNext(1);
+  CHECK(!bus.read(in, 2));
+  CHECK_EQ(bus.failures(), 1);
+  bus.reset();
+  CHECK_EQ(bus.transactions(), 0);
+
+  // A single-shot read costs a config write, the polls and one combined
+  // pointer write and read
+  Adafruit_ADS1115 ads;
+  CHECK(ads.begin(&bus));
+  ads.setDataRate(ADS1115_RATE_860SPS);
+  int16_t counts;
+  ads.readADC(MUX_BY_CHANNEL[0], &counts);
+  bus.reset();
+  ads.readADC(MUX_BY_CHANNEL[0], &counts);
+  uint32_t polls = bus.transactions() - 2;
+  CHECK(polls >= 1);
+  CHECK_EQ(bus.starts(), bus.transactions() + 1);
+  CHECK_EQ(bus.bytes(), 3 + polls * 2 + 3);
+}
+
+static void testStats() {
+  FakeADS1X15 chip(16);
+  Adafruit_ADS1115 ads;
+  start(ads, chip);
+  int16_t counts;
+  adsStats_t stats;
+  stats.regReads = 99;
+  ads.setStats(&stats);
+  CHECK_EQ(stats.regReads, 0);
+
+  ads.readADC(MUX_BY_CHANNEL[0], &counts);
+  CHECK_EQ(stats.regWrites, chip.writes);
+  CHECK_EQ(stats.regReads, chip.reads + chip.combined);
+  CHECK(stats.pollIterations >= 1);
+  CHECK_EQ(stats.i2cErrors, 0);
+  // 860SPS converts in 1.2ms, in the 1024-2048us bucket
+  uint32_t total = 0;
+  for (uint8_t i = 0; i < ADS1X15_LATENCY_BUCKETS; i++) {
+    total += stats.latency[i];
+  }
+  CHECK_EQ(total, 1);
+  CHECK(stats.latency[0] == 0);
+
+  chip.failNext(1);
+  ads.readADC(MUX_BY_CHANNEL[0], &counts);
+  CHECK_EQ(stats.i2cErrors, 1);
+
+  ads.setStats(NULL);
+  uint32_t writes = stats.regWrites;
+  ads.readADC(MUX_BY_CHANNEL[0], &counts);
+  CHECK_EQ(stats.regWrites, writes);
+}
+
+static void testTrace() {
+  FakeADS1X15 chip(16);
+  Adafruit_ADS1115 ads;
+  start(ads, chip);
+  chip.setInput(MUX_BY_CHANNEL[0], volts(100, 6.144f));
+  chip.setTiming(0);
+  adsTraceEntry_t entries[16];
+  adsTrace_t trace = {entries, 16, 0, 0};
+  ads.setTrace(&trace);
+
+  int16_t counts;
+  ads.readADC(MUX_BY_CHANNEL[0], &counts);
+  // Config, RDY mode thresholds, one poll and the result
+  CHECK_EQ(trace.count, 5);
+  CHECK_EQ(trace.dropped, 0);
+  CHECK_EQ(entries[0].reg, ADS1X15_REG_POINTER_CONFIG);
+  CHECK_EQ(entries[0].flags, 0);
+  CHECK_EQ(entries[1].reg, ADS1X15_REG_POINTER_HITHRESH);
+  CHECK_EQ(entries[1].value, 0x8000);
+  CHECK_EQ(entries[3].reg, ADS1X15_REG_POINTER_CONFIG);
+  CHECK(entries[3].flags & ADS1X15_TRACE_READ);
+  CHECK_EQ(entries[4].reg, ADS1X15_REG_POINTER_CONVERT);
+  CHECK_EQ(entries[4].value, 100);
+
+  // Played back, the recording reproduces the reading
+  ads.setTrace(NULL);
+  Adafruit_ADS1X15_ReplayTransport replay(entries, trace.count);
+  Adafruit_ADS1115 replayed;
+  CHECK(replayed.begin(&replay));
+  replayed.setDataRate(ADS1115_RATE_860SPS);
+  CHECK_EQ(replayed.readADC(MUX_BY_CHANNEL[0], &counts), ADS1X15_OK);
+  CHECK_EQ(counts, 100);
+  CHECK(replay.finished());
+  CHECK_EQ(replay.mismatches(), 0);
+
+  // A full trace counts what it could not record
+  trace.size = 2;
+  ads.setTrace(&trace);
+  ads.readADC(MUX_BY_CHANNEL[0], &counts);
+  CHECK_EQ(trace.count, 2);
+  CHECK_EQ(trace.dropped, 1);
+}
+
+/** Calls made to countAsync() */
+static uint8_t asyncCalls;
+
+/*!
+    @brief  Counts pollAsync() callbacks
+    @param conv the finished conversion
+*/
+static void countAsync(adsConversion_t *conv) {
+  (void)conv;
+  asyncCalls++;
+}
+
+static void testAsync() {
+  FakeADS1X15 chip(16);
+  Adafruit_ADS1115 ads;
+  start(ads, chip);
+  chip.setInput(MUX_BY_CHANNEL[2], volts(4321, 6.144f));
+
+  adsConversion_t conv;
+  ads.startAsync(&conv, MUX_BY_CHANNEL[2]);
+  CHECK_EQ(conv.state, ADS1X15_CONV_PENDING);
+  ads.setGain(GAIN_ONE);
+  uint32_t start = millis();
+  while (ads.pollAsync(&conv) == ADS1X15_CONV_PENDING &&
+         millis() - start < 100)
+    ;
+  CHECK_EQ(conv.state, ADS1X15_CONV_DONE);
+  CHECK_EQ(conv.counts, 4321);
+  // Scaled with the gain it was started with
+  CHECK_NEAR(conv.volts, volts(4321, 6.144f), 1e-4);
+
+  adsConversion_t first, second;
+  ads.startAsync(&first, MUX_BY_CHANNEL[0]);
+  ads.startAsync(&second, MUX_BY_CHANNEL[1]);
+  CHECK_EQ(ads.pollAsync(&first), ADS1X15_CONV_SUPERSEDED);
+
+  // However many times the device was reconfigured in between
+  ads.startAsync(&first, MUX_BY_CHANNEL[0]);
+  for (uint16_t i = 0; i < 256; i++) {
+    ads.startADCReading(MUX_BY_CHANNEL[1], /*continuous=*/false);
+  }
+  delay(5);
+  CHECK_EQ(ads.pollAsync(&first), ADS1X15_CONV_SUPERSEDED);
+
+  // A result that can't be read is an error, not a reading of 0
+  asyncCalls = 0;
+  ads.startAsync(&conv, MUX_BY_CHANNEL[2], countAsync);
+  chip.failNext(1);
+  CHECK_EQ(ads.pollAsync(&conv, /*dataReady=*/true), ADS1X15_CONV_ERROR);
+  CHECK_EQ(ads.getStatus(), ADS1X15_ERR_BUS);
+  CHECK_EQ(asyncCalls, 1);
+  CHECK_EQ(ads.pollAsync(&conv), ADS1X15_CONV_ERROR);
+  CHECK_EQ(asyncCalls, 1);
+}
+
+static void testAutoRange() {
+  FakeADS1X15 chip(16);
+  Adafruit_ADS1115 ads;
+  start(ads, chip);
+  uint16_t mux = MUX_BY_CHANNEL[0];
+  chip.setInput(mux, 0.01f);
+
+  // A small signal climbs a gain step per reading
+  float v = 0;
+  for (uint8_t i = 0; i < 6; i++) {
+    v = ads.readADC_AutoRange(mux);
+  }
+  CHECK_EQ(ads.getAutoRangeGain(mux), GAIN_SIXTEEN);
+  CHECK_NEAR(v, 0.01f, 1e-5);
+
+  // A saturated reading is repeated at wider ranges straight away
+  chip.setInput(mux, 3.0f);
+  int16_t counts;
+  adsGain_t gain;
+  v = ads.readADC_AutoRange(mux, &counts, &gain);
+  CHECK_EQ(gain, GAIN_ONE);
+  CHECK_NEAR(v, 3.0f, 1e-3);
+  CHECK_EQ(counts, 24000);
+  CHECK_EQ(ads.getAutoRangeGain(mux), GAIN_ONE);
+
+  // Each mux setting remembers its own gain
+  CHECK_EQ(ads.getAutoRangeGain(MUX_BY_CHANNEL[1]), GAIN_TWOTHIRDS);
+  ads.setAutoRangeGain(MUX_BY_CHANNEL[1], GAIN_EIGHT);
+  CHECK_EQ(ads.getAutoRangeGain(MUX_BY_CHANNEL[1]), GAIN_EIGHT);
+  CHECK_EQ(ads.getAutoRangeGain(mux), GAIN_ONE);
+}
+
+static void testAutoRangeErrors() {
+  FakeADS1X15 chip(16);
+  Adafruit_ADS1115 ads;
+  start(ads, chip);
+  uint16_t mux = MUX_BY_CHANNEL[0];
+  chip.setInput(mux, 0.01f);
+  ads.setAutoRangeGain(mux, GAIN_FOUR);
+
+  // A failed reading reports why and keeps the remembered gain
+  float v = 1;
+  int16_t counts = 1;
+  adsGain_t gain = GAIN_EIGHT;
+  chip.failNext(1);
+  CHECK_EQ(ads.readADC_AutoRange(mux, &v, &counts, &gain), ADS1X15_ERR_BUS);
+  CHECK_EQ(v, 0);
+  CHECK_EQ(counts, 0);
+  CHECK_EQ(gain, GAIN_EIGHT);
+  CHECK_EQ(ads.getAutoRangeGain(mux), GAIN_FOUR);
+
+  chip.setTiming(1000);
+  ads.setConversionTimeout(1);
+  CHECK_EQ(ads.readADC_AutoRange(mux, &v), ADS1X15_ERR_TIMEOUT);
+  CHECK_EQ(ads.getAutoRangeGain(mux), GAIN_FOUR);
+  chip.setTiming(100);
+  ads.setConversionTimeout(250);
+
+  // It goes through the breaker like the other status-returning reads
+  ads.setCircuitBreaker(1, 1000);
+  chip.setPresent(false);
+  CHECK_EQ(ads.readADC_AutoRange(mux, &v), ADS1X15_ERR_BUS);
+  CHECK(ads.circuitOpen());
+  CHECK_EQ(ads.readADC_AutoRange(mux, &v), ADS1X15_ERR_OFFLINE);
+  CHECK_EQ(ads.readADC_AutoRange(mux), 0);
+  CHECK_EQ(ads.getStatus(), ADS1X15_ERR_OFFLINE);
+
+  // And recovers the chip with the watchdog on
+  ads.setCircuitBreaker(0, 0);
+  ads.setWatchdog(true);
+  chip.setPresent(true);
+  CHECK_EQ(ads.readADC_AutoRange(mux, &v, &counts, &gain), ADS1X15_OK);
+  CHECK_EQ(gain, GAIN_FOUR);
+  CHECK_NEAR(v, 0.01f, 1e-4);
+  CHECK_EQ(ads.getAutoRangeGain(mux), GAIN_EIGHT);
+}
+
+static void testPlanScan() {
+  FakeADS1X15 chip(16);
+  Adafruit_ADS1115 ads;
+  start(ads, chip);
+  adsScanEntry_t table[32];
+  uint8_t length;
+  float load = -1;
+
+  // The slow channel fits in the cycle at 32SPS, but one step of it
+  // between two of the fast channel's would hold that for 38ms
+  adsScanTarget_t targets[] = {
+      {MUX_BY_CHANNEL[0], GAIN_ONE, 100.0f, 0},
+      {MUX_BY_CHANNEL[1], GAIN_ONE, 8.0f, 0},
+  };
+  CHECK(ads.planScan(targets, 2, table, 32, &length, &load));
+  CHECK_EQ(length, 14);
+  CHECK(load > 0 && load <= 1);
+  uint32_t slowStep = 1100000UL / ADS1115_Traits::sps(targets[1].rate);
+  uint32_t fastStep = 1100000UL / ADS1115_Traits::sps(targets[0].rate);
+  CHECK(slowStep + fastStep + 2 * ADS1X15_SCAN_OVERHEAD <= 10000);
+
+  // At 400 SPS nothing else fits between two samples, though the cycle
+  // as a whole does
+  targets[0].hz = 400.0f;
+  CHECK(!ads.planScan(targets, 2, table, 64, &length, &load));
+  CHECK_EQ(length, 51);
+  CHECK(load <= 1);
+
+  CHECK(!ads.planScan(targets, 0, table, 64, &length, &load));
+  CHECK_EQ(length, 0);
+  CHECK_EQ(load, 0);
+}
+
+static void testScanOrder() {
+  // Conversions that finish straight away, as at a fast data rate on a
+  // slow bus: each result must be read before the next step starts
+  static const adsScanEntry_t sequence[] = {{MUX_BY_CHANNEL[0], GAIN_ONE},
+                                            {MUX_BY_CHANNEL[1], GAIN_ONE},
+                                            {MUX_BY_CHANNEL[2], GAIN_ONE}};
+  FakeADS1X15 chip(16);
+  Adafruit_ADS1115 ads;
+  start(ads, chip);
+  chip.setTiming(0);
+  chip.setInput(MUX_BY_CHANNEL[0], volts(100, 4.096f));
+  chip.setInput(MUX_BY_CHANNEL[1], volts(200, 4.096f));
+  chip.setInput(MUX_BY_CHANNEL[2], volts(4000, 4.096f));
+
+  Adafruit_ADS1X15_Scan scan(&ads);
+  int16_t results[3] = {0, 0, 0};
+  scan.start(sequence, 3, results, /*repeat=*/false);
+  uint8_t steps = 0;
+  while (!scan.update(/*dataReady=*/true) && steps < 10) {
+    steps++;
+  }
+  CHECK_EQ(steps, 2);
+  CHECK(!scan.active());
+  CHECK_EQ(results[0], 100);
+  CHECK_EQ(results[1], 200);
+  CHECK_EQ(results[2], 4000);
+}
+
+static void testScanPolled() {
+  static const adsScanEntry_t sequence[] = {
+      {MUX_BY_CHANNEL[3], GAIN_TWOTHIRDS},
+      {ADS1X15_REG_CONFIG_MUX_DIFF_0_1, GAIN_FOUR}};
+  FakeADS1X15 chip(16);
+  Adafruit_ADS1115 ads;
+  start(ads, chip);
+  chip.setInput(MUX_BY_CHANNEL[3], volts(3000, 6.144f));
+  chip.setInput(ADS1X15_REG_CONFIG_MUX_DIFF_0_1, volts(-5000, 1.024f));
+
+  Adafruit_ADS1X15_Scan scan(&ads);
+  int16_t results[2] = {0, 0};
+  adsSample_t samples[2];
+  scan.setSamples(samples);
+  scan.start(sequence, 2, results);
+  uint32_t start = millis();
+  while (!scan.update() && millis() - start < 100)
+    ;
+  CHECK(scan.active());
+  CHECK_EQ(results[0], 3000);
+  CHECK_EQ(results[1], -5000);
+  CHECK_EQ(samples[1].mux, ADS1X15_REG_CONFIG_MUX_DIFF_0_1);
+  CHECK_EQ(scan.getSkew(), samples[1].timestamp - samples[0].timestamp);
+  CHECK(scan.getSkew() >= ads.getConversionDelay() * 9 / 10);
+  scan.stop();
+  CHECK(!scan.active());
+}
+
+static void testScanReadyEdge() {
+  static const adsScanEntry_t sequence[] = {{MUX_BY_CHANNEL[0], GAIN_ONE},
+                                            {MUX_BY_CHANNEL[1], GAIN_ONE}};
+  FakeADS1X15 chip(16);
+  Adafruit_ADS1115 ads;
+  start(ads, chip);
+  chip.setTiming(0);
+
+  Adafruit_ADS1X15_Scan scan(&ads);
+  int16_t results[2] = {0, 0};
+  adsSample_t samples[2];
+  scan.setSamples(samples);
+  scan.start(sequence, 2, results);
+
+  // A result handled late is stamped with the edge dataReadyISR() saw
+  ads.dataReadyISR();
+  uint32_t edge = micros();
+  delay(5);
+  CHECK(!scan.update(/*dataReady=*/true));
+  CHECK(edge - samples[0].timestamp < 1000);
+
+  // Without an edge the time it was handled is the best there is
+  delay(5);
+  CHECK(scan.update(/*dataReady=*/true));
+  CHECK(micros() - samples[1].timestamp < 1000);
+  scan.stop();
+}
+
+static void testStream() {
+  FakeADS1X15 chip(16);
+  Adafruit_ADS1115 ads;
+  start(ads, chip);
+  chip.setInput(MUX_BY_CHANNEL[3], volts(-4000, 6.144f));
+
+  Adafruit_ADS1X15_Stream stream(&ads);
+  adsSample_t buffer[4];
+  CHECK(!stream.start(MUX_BY_CHANNEL[3], buffer, 3));
+  CHECK(stream.start(MUX_BY_CHANNEL[3], buffer, 4));
+  CHECK(!stream.service());
+
+  delay(2);
+  ads.dataReadyISR();
+  CHECK(stream.service());
+  CHECK_EQ(stream.available(), 1);
+
+  // Two edges before service() means one conversion was missed
+  ads.dataReadyISR();
+  ads.dataReadyISR();
+  CHECK(stream.service());
+  CHECK_EQ(stream.getOverruns(), 1);
+
+  adsSample_t out[4];
+  CHECK_EQ(stream.read(out, 4), 2);
+  CHECK_EQ(out[0].counts, -4000);
+  CHECK_EQ(out[0].mux, MUX_BY_CHANNEL[3]);
+  CHECK(out[1].timestamp - out[0].timestamp < 1000000UL);
+  CHECK_EQ(stream.available(), 0);
+
+  // A full buffer drops samples rather than overwriting them
+  for (uint8_t i = 0; i < 5; i++) {
+    ads.dataReadyISR();
+    stream.service();
+  }
+  CHECK_EQ(stream.available(), 4);
+  CHECK_EQ(stream.getOverruns(), 2);
+
+  stream.stop();
+  CHECK_EQ(chip.reg(ADS1X15_REG_POINTER_CONFIG) & ADS1X15_REG_CONFIG_MODE_MASK,
+           ADS1X15_REG_CONFIG_MODE_SINGLE);
+}
+
+static void testFailedReads() {
+  FakeADS1X15 chip(16);
+  Adafruit_ADS1115 ads;
+  start(ads, chip);
+  chip.setTiming(0);
+  chip.setInput(MUX_BY_CHANNEL[0], volts(100, 6.144f));
+  chip.setInput(MUX_BY_CHANNEL[1], volts(200, 6.144f));
+
+  // A burst stops at the failed read and keeps the readings before it:
+  // after the config write, two reads get through
+  int16_t burst[4] = {0, 0, 0, 0};
+  CHECK_EQ(ads.readBurst(MUX_BY_CHANNEL[0], burst, 4), 4);
+  chip.failNext(1, 3);
+  CHECK_EQ(ads.readBurst(MUX_BY_CHANNEL[0], burst, 4), 2);
+  CHECK_EQ(ads.getStatus(), ADS1X15_ERR_BUS);
+  CHECK_EQ(burst[1], 100);
+
+  // A stream drops the sample instead of buffering a 0
+  Adafruit_ADS1X15_Stream stream(&ads);
+  adsSample_t buffer[4];
+  CHECK(stream.start(MUX_BY_CHANNEL[0], buffer, 4));
+  ads.dataReadyISR();
+  chip.failNext(1);
+  CHECK(!stream.service());
+  CHECK_EQ(stream.getErrors(), 1);
+  CHECK_EQ(stream.available(), 0);
+  ads.dataReadyISR();
+  CHECK(stream.service());
+  adsSample_t sample;
+  CHECK_EQ(stream.read(&sample, 1), 1);
+  CHECK_EQ(sample.counts, 100);
+  stream.stop();
+
+  // A scan converts the step again, so the sweep has every reading
+  static const adsScanEntry_t sequence[] = {{MUX_BY_CHANNEL[0], GAIN_ONE},
+                                            {MUX_BY_CHANNEL[1], GAIN_ONE}};
+  Adafruit_ADS1X15_Scan scan(&ads);
+  int16_t results[2] = {-1, -1};
+  scan.start(sequence, 2, results, /*repeat=*/false);
+  chip.failNext(1);
+  uint8_t steps = 0;
+  while (!scan.update(/*dataReady=*/true) && steps < 10) {
+    steps++;
+  }
+  CHECK_EQ(scan.getErrors(), 1);
+  CHECK_EQ(results[0], 150);
+  CHECK_EQ(results[1], 300);
+
+  // A group flags the chip whose result could not be read
+  Adafruit_ADS1X15_Group group;
+  group.add(&ads);
+  int16_t result = -1;
+  group.start(MUX_BY_CHANNEL[1], &result);
+  chip.failNext(1, 1);
+  while (!group.update())
+    ;
+  CHECK_EQ(group.getFailed(), 1);
+  CHECK_EQ(result, 0);
+  CHECK(group.readAll(MUX_BY_CHANNEL[1], &result));
+  CHECK_EQ(group.getFailed(), 0);
+}
+
+static void testGroup() {
+  FakeADS1X15 chip0(16), chip1(12);
+  Adafruit_ADS1115 ads0;
+  Adafruit_ADS1015 ads1;
+  start(ads0, chip0);
+  start(ads1, chip1);
+  chip0.setInput(MUX_BY_CHANNEL[0], volts(1000, 6.144f));
+  chip1.setInput(MUX_BY_CHANNEL[0], volts(1600, 6.144f));
+
+  Adafruit_ADS1X15_Group group;
+  CHECK(group.add(&ads0));
+  CHECK(group.add(&ads1));
+  CHECK_EQ(group.size(), 2);
+  int16_t results[2] = {0, 0};
+  CHECK(group.readAll(MUX_BY_CHANNEL[0], results));
+  CHECK_EQ(results[0], 1000);
+  CHECK_EQ(results[1], 100);
+}
+
+int main() {
+  RUN(testSignExtension1015);
+  RUN(testSignExtension1115);
+  RUN(testComputeVolts);
+  RUN(testSingleEnded);
+  RUN(testDifferential);
+  RUN(testContinuous);
+  RUN(testSingleShot);
+  RUN(testComparator);
+  RUN(testWindowComparator);
+  RUN(testTimeout);
+  RUN(testRecoverBeforeBegin);
+  RUN(testBusErrors);
+  RUN(testRegisterCache);
+  RUN(testCountingTransport);
+  RUN(testStats);
+  RUN(testTrace);
+  RUN(testAsync);
+  RUN(testAutoRange);
+  RUN(testAutoRangeErrors);
+  RUN(testPlanScan);
+  RUN(testScanOrder);
+  RUN(testScanPolled);
+  RUN(testScanReadyEdge);
+  RUN(testStream);
+  RUN(testFailedReads);
+  RUN(testGroup);
+  return testResult();
+}
@@ -0,0 +1,80 @@
+/**************************************************************************/
+/*!
+    @file     test_filter.cpp
+
+    Host tests for the ADS1X15 integer filter stages.
+
+    BSD license, all text here must be included in any redistribution
+*/
+/**************************************************************************/
+#include "Adafruit_ADS1X15_Filter.h"
+#include "test.h"
+
+/*!
+    @brief  Pushes a constant input until the filter has settled
+    @param filter filter under test
+    @param in input sample
+    @param n samples to push
+    @return the last output
+*/
+static int16_t settle(Adafruit_ADS1X15_Filter &filter, int16_t in, int n) {
+  int16_t out = 0x1234;
+  for (int i = 0; i < n; i++) {
+    filter.push(in, &out);
+  }
+  return out;
+}
+
+static void testDecimatorFullScale() {
+  // R^ORDER = 65536, the most the 32-bit state allows
+  Adafruit_ADS1X15_Decimator<16, 4> low, high;
+  CHECK_EQ(settle(low, -32768, 16 * 8), -32768);
+  CHECK_EQ(settle(high, 32767, 16 * 8), 32767);
+}
+
+static void testDecimatorRate() {
+  Adafruit_ADS1X15_Decimator<4, 2> dec;
+  int16_t out;
+  uint8_t outputs = 0;
+  for (uint8_t i = 0; i < 40; i++) {
+    outputs += dec.push(100, &out);
+  }
+  CHECK_EQ(outputs, 10);
+  CHECK_EQ(out, 100);
+
+  // Rounds to the nearest count either side of zero
+  Adafruit_ADS1X15_Decimator<2> pair;
+  CHECK(!pair.push(1, &out));
+  CHECK(pair.push(2, &out));
+  CHECK_EQ(out, 2);
+  pair.push(-1, &out);
+  CHECK(pair.push(-2, &out));
+  CHECK_EQ(out, -2);
+}
+
+static void testChain() {
+  Adafruit_ADS1X15_Median<3> median;
+  Adafruit_ADS1X15_MovingAverage<2> average;
+  median.chain(&average);
+
+  static const int16_t in[] = {10, 10, 5000, 10, 20, 20};
+  int16_t out = 0, peak = 0;
+  uint8_t outputs = 0;
+  for (uint8_t i = 0; i < 6; i++) {
+    if (median.process(in[i], &out)) {
+      outputs++;
+      peak = (out > peak) ? out : peak;
+    }
+  }
+  // The spike never reaches the average
+  CHECK_EQ(outputs, 3);
+  CHECK_EQ(out, 20);
+  CHECK_EQ(peak, 20);
+}
+
+int main() {
+  RUN(testDecimatorFullScale);
+  RUN(testDecimatorRate);
+  RUN(testChain);
+  return testResult();
+}
@@ -0,0 +1,117 @@
+/**************************************************************************/
+/*!
+    @file     test_log.cpp
+
+    Host tests for the ADS1X15 binary log encoder and decoder.
+
+    BSD license, all text here must be included in any redistribution
+*/
+/**************************************************************************/
+#include "Adafruit_ADS1X15_Log.h"
+#include "test.h"
+
+#include <string.h>
+
+/** Encoded bytes captured from an encoder */
+struct Capture {
+  uint8_t data[1024]; ///< Bytes written
+  size_t len;         ///< Bytes in data
+};
+
+/** Readings passed out of a decoder */
+struct Readings {
+  uint8_t channel[256]; ///< Channel of each reading
+  int16_t counts[256];  ///< Value of each reading
+  size_t len;           ///< Readings seen
+};
+
+static void capture(void *context, const uint8_t *data, size_t len) {
+  Capture *out = (Capture *)context;
+  memcpy(&out->data[out->len], data, len);
+  out->len += len;
+}
+
+static void collect(void *context, uint8_t channel, int16_t counts) {
+  Readings *out = (Readings *)context;
+  out->channel[out->len] = channel;
+  out->counts[out->len] = counts;
+  out->len++;
+}
+
+static void decode(const uint8_t *data, size_t len,
+                   Adafruit_ADS1X15_LogDecoder &decoder) {
+  for (size_t i = 0; i < len; i++) {
+    decoder.feed(data[i]);
+  }
+}
+
+static void testRoundTrip() {
+  static const int16_t in[] = {0, 1, -1, 300, 32767, -32768, -5, 7, 7};
+  Capture bytes = {{0}, 0};
+  Adafruit_ADS1X15_LogEncoder<2, 4> encoder(capture, &bytes);
+  adsLogHeader_t header = {16, 2, 7, 2};
+  encoder.begin(&header);
+  CHECK(!encoder.push(2, 0));
+  for (uint8_t i = 0; i < 9; i++) {
+    CHECK(encoder.push(i & 1, in[i]));
+  }
+  encoder.flush();
+
+  Readings out = {{0}, {0}, 0};
+  Adafruit_ADS1X15_LogDecoder decoder(collect, &out);
+  decode(bytes.data, bytes.len, decoder);
+  CHECK(decoder.hasHeader());
+  CHECK_EQ(decoder.header()->bits, 16);
+  CHECK_EQ(decoder.header()->rate, 7);
+  CHECK_EQ(decoder.errors(), 0);
+  CHECK_EQ(out.len, 9);
+
+  // Readings come out per channel, in the order they were pushed
+  int16_t expect[2][5];
+  uint8_t seen[2] = {0, 0};
+  for (uint8_t i = 0; i < 9; i++) {
+    expect[i & 1][i / 2] = in[i];
+  }
+  for (size_t i = 0; i < out.len; i++) {
+    uint8_t channel = out.channel[i];
+    CHECK_EQ(out.counts[i], expect[channel][seen[channel]++]);
+  }
+  CHECK_EQ(seen[0], 5);
+  CHECK_EQ(seen[1], 4);
+}
+
+static void testResync() {
+  // Three packed 12-bit blocks of channel 0
+  Capture bytes = {{0}, 0};
+  Adafruit_ADS1X15_LogEncoder<1, 4> encoder(capture, &bytes);
+  adsLogHeader_t header = {12, 0, 4, 1};
+  encoder.begin(&header);
+  size_t headerLen = bytes.len;
+  for (int16_t i = 0; i < 12; i++) {
+    encoder.push(0, (int16_t)(i * 301 - 2000));
+  }
+  size_t blockLen = (bytes.len - headerLen) / 3;
+  CHECK_EQ(bytes.len, headerLen + 3 * blockLen);
+
+  // Lose the checksum of the first block, so the decoder takes the first
+  // byte of the second block in its place
+  Capture cut = {{0}, 0};
+  size_t keep = headerLen + blockLen - 1;
+  capture(&cut, bytes.data, keep);
+  capture(&cut, &bytes.data[keep + 1], bytes.len - keep - 1);
+
+  Readings out = {{0}, {0}, 0};
+  Adafruit_ADS1X15_LogDecoder decoder(collect, &out);
+  decode(cut.data, cut.len, decoder);
+  CHECK(decoder.errors() >= 1);
+  CHECK_EQ(out.len, 8);
+  for (size_t i = 0; i < out.len; i++) {
+    CHECK_EQ(out.counts[i], (int16_t)((i + 4) * 301 - 2000));
+  }
+}
+
+int main() {
+  RUN(testRoundTrip);
+  RUN(testResync);
+  return testResult();
+}
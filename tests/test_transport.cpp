@@ -0,0 +1,156 @@
+/**************************************************************************/
+/*!
+    @file     test_transport.cpp
+
+    Host tests for the ADS1X15 register layer and the transports it runs
+    over, using FakeADS1X15 in place of the chip.
+
+    BSD license, all text here must be included in any redistribution
+*/
+/**************************************************************************/
+#include "Adafruit_ADS1X15.h"
+#include "ads1x15_fake.h"
+#include "test.h"
+
+/** Transport that leaves writeThenRead() to the base class */
+class SplitTransport : public Adafruit_ADS1X15_Transport {
+public:
+  /*!
+      @brief  Instantiates a transport over a fake chip
+      @param chip the fake chip
+  */
+  SplitTransport(FakeADS1X15 *chip) : m_chip(chip) {}
+  bool begin() { return m_chip->begin(); }
+  bool write(const uint8_t *buffer, size_t len) {
+    return m_chip->write(buffer, len);
+  }
+  bool read(uint8_t *buffer, size_t len) { return m_chip->read(buffer, len); }
+
+private:
+  FakeADS1X15 *m_chip; ///< Chip the transactions go to
+};
+
+/** Fake that reports when it is destroyed */
+class OwnedFake : public FakeADS1X15 {
+public:
+  /*!
+      @brief  Instantiates a fake chip
+      @param gone set when the fake is destroyed
+  */
+  OwnedFake(bool *gone) : m_gone(gone) {}
+  ~OwnedFake() { *m_gone = true; }
+
+private:
+  bool *m_gone; ///< Set by the destructor
+};
+
+static void testCombinedRead() {
+  FakeADS1X15 chip(16);
+  chip.setTiming(0);
+  chip.setInput(MUX_BY_CHANNEL[1], 1.0f);
+  Adafruit_ADS1115 ads;
+  CHECK(ads.begin(&chip));
+  ads.setGain(GAIN_ONE);
+
+  int16_t counts;
+  CHECK_EQ(ads.readADC(MUX_BY_CHANNEL[1], &counts), ADS1X15_OK);
+  CHECK_EQ(counts, 8000);
+
+  // The pointer is left at the conversion register, so reading it again
+  // needs no pointer write at all
+  uint32_t writes = chip.writes;
+  uint32_t reads = chip.reads;
+  uint32_t combined = chip.combined;
+  CHECK_EQ(ads.getLastConversionResults(), 8000);
+  CHECK_EQ(chip.writes, writes);
+  CHECK_EQ(chip.combined, combined);
+  CHECK_EQ(chip.reads - reads, 1);
+}
+
+static void testSplitWriteThenRead() {
+  FakeADS1X15 chip(16);
+  chip.setTiming(0);
+  chip.setInput(MUX_BY_CHANNEL[2], -0.5f);
+  SplitTransport bus(&chip);
+  Adafruit_ADS1115 ads;
+  CHECK(ads.begin(&bus));
+  ads.setGain(GAIN_ONE);
+
+  // Without an override, every pointer write and read is two transactions
+  int16_t counts;
+  CHECK_EQ(ads.readADC(MUX_BY_CHANNEL[2], &counts), ADS1X15_OK);
+  CHECK_EQ(counts, -4000);
+  CHECK_EQ(chip.combined, 0);
+  CHECK(chip.reads >= 2);
+}
+
+static void testReplayCounts() {
+  FakeADS1X15 chip(16);
+  chip.setTiming(0);
+  chip.setInput(MUX_BY_CHANNEL[0], 1.0f);
+  Adafruit_ADS1115 ads;
+  CHECK(ads.begin(&chip));
+  ads.setGain(GAIN_ONE);
+  adsTraceEntry_t entries[16];
+  adsTrace_t trace = {entries, 16, 0, 0};
+  ads.setTrace(&trace);
+  int16_t counts;
+  ads.readADC(MUX_BY_CHANNEL[0], &counts);
+  ads.setTrace(NULL);
+
+  // A different channel writes a different config value
+  Adafruit_ADS1X15_ReplayTransport replay(entries, trace.count);
+  Adafruit_ADS1115 other;
+  CHECK(other.begin(&replay));
+  other.setGain(GAIN_ONE);
+  other.readADC(MUX_BY_CHANNEL[3], &counts);
+  CHECK(replay.finished());
+  CHECK_EQ(replay.mismatches(), 1);
+  CHECK_EQ(replay.skipped(), 0);
+  CHECK_EQ(replay.extra(), 0);
+
+  // Reading the result without polling skips the recorded poll, and a
+  // second read is not in the recording
+  CHECK(other.begin(&replay));
+  other.startADCReading(MUX_BY_CHANNEL[0], /*continuous=*/false);
+  CHECK_EQ(other.getLastConversionResults(), 8000);
+  CHECK(replay.finished());
+  CHECK_EQ(replay.skipped(), 1);
+  CHECK_EQ(replay.extra(), 0);
+  other.getLastConversionResults();
+  CHECK_EQ(replay.extra(), 1);
+}
+
+static void testVirtualDestructor() {
+  bool gone = false;
+  Adafruit_ADS1X15_Transport *bus = new OwnedFake(&gone);
+  delete bus;
+  CHECK(gone);
+}
+
+#if defined(__linux__)
+static void testLinuxMissingDevice() {
+  Adafruit_ADS1X15_LinuxI2C bus("/dev/i2c-does-not-exist", ADS1X15_ADDRESS);
+  uint8_t in[2];
+  CHECK(!bus.begin());
+  CHECK(!bus.read(in, 2));
+  Adafruit_ADS1115 ads;
+  CHECK(!ads.begin(&bus));
+
+  // A device that opens but has no chip behind it is closed again
+  Adafruit_ADS1X15_LinuxI2C null("/dev/null", ADS1X15_ADDRESS);
+  CHECK(!null.begin());
+  CHECK(!null.read(in, 2));
+}
+#endif
+
+int main() {
+  RUN(testCombinedRead);
+  RUN(testSplitWriteThenRead);
+  RUN(testReplayCounts);
+  RUN(testVirtualDestructor);
+#if defined(__linux__)
+  RUN(testLinuxMissingDevice);
+#endif
+  return testResult();
+}
@@ -0,0 +1,60 @@
+/**************************************************************************/
+/*!
+    @file     ads1x15_decode.cpp
+
+    Host tool that decodes an Adafruit_ADS1X15_Log stream, captured from
+    a serial port or read off an SD card, into CSV on stdout:
+
+        channel,counts,volts
+
+    Build from the library directory with:
+
+        g++ -O2 -I. -o ads1x15_decode tools/ads1x15_decode.cpp \
+            Adafruit_ADS1X15_Log.cpp
+
+    Usage: ads1x15_decode [file]    (reads stdin if no file is given)
+
+    BSD license, all text here must be included in any redistribution
+*/
+/**************************************************************************/
+#include "Adafruit_ADS1X15_Log.h"
+
+#include <stdio.h>
+
+static Adafruit_ADS1X15_LogDecoder *decoder;
+
+static void printReading(void *context, uint8_t channel, int16_t counts) {
+  FILE *out = (FILE *)context;
+  fprintf(out, "%u,%d,%.6f\n", channel, counts,
+          adsLogVolts(decoder->header(), counts));
+}
+
+int main(int argc, char **argv) {
+  FILE *in = stdin;
+  if (argc > 1) {
+    in = fopen(argv[1], "rb");
+    if (in == NULL) {
+      perror(argv[1]);
+      return 1;
+    }
+  }
+
+  Adafruit_ADS1X15_LogDecoder log(printReading, stdout);
+  decoder = &log;
+
+  printf("channel,counts,volts\n");
+  int c;
+  while ((c = fgetc(in)) != EOF) {
+    log.feed((uint8_t)c);
+  }
+
+  if (!log.hasHeader()) {
+    fprintf(stderr, "no header found\n");
+    return 1;
+  }
+  if (log.errors() != 0) {
+    fprintf(stderr, "%lu corrupt frames skipped\n",
+            (unsigned long)log.errors());
+  }
+  return 0;
+}
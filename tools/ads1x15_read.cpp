@@ -0,0 +1,73 @@
+/**************************************************************************/
+/*!
+    @file     ads1x15_read.cpp
+
+    Reads the four single-ended channels of an ADS1115 on a Linux host
+    through /dev/i2c-N, once a second, using the same driver as the
+    Arduino sketches.
+
+    Build from the library directory with:
+
+        g++ -O2 -I. -o ads1x15_read tools/ads1x15_read.cpp \
+            Adafruit_ADS1X15.cpp Adafruit_ADS1X15_Transport.cpp
+
+    Usage: ads1x15_read [device] [address]
+           e.g. ads1x15_read /dev/i2c-1 0x48
+
+    BSD license, all text here must be included in any redistribution
+*/
+/**************************************************************************/
+#include "Adafruit_ADS1X15.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/*!
+    @brief  Describes a read status for the error output
+    @param status status of the read
+    @return a short description
+*/
+static const char *statusName(adsStatus_t status) {
+  switch (status) {
+  case ADS1X15_OK:
+    return "ok";
+  case ADS1X15_ERR_ARGUMENT:
+    return "bad argument";
+  case ADS1X15_ERR_BUS:
+    return "bus error";
+  case ADS1X15_ERR_TIMEOUT:
+    return "no response";
+  case ADS1X15_ERR_OFFLINE:
+    return "offline";
+  }
+  return "?";
+}
+
+int main(int argc, char **argv) {
+  const char *device = (argc > 1) ? argv[1] : "/dev/i2c-1";
+  uint8_t addr = (argc > 2) ? strtoul(argv[2], NULL, 0) : ADS1X15_ADDRESS;
+
+  Adafruit_ADS1X15_LinuxI2C bus(device, addr);
+  Adafruit_ADS1115 ads; /* Use Adafruit_ADS1015 for the 12-bit version */
+
+  if (!ads.begin(&bus)) {
+    perror(device);
+    return 1;
+  }
+
+  while (1) {
+    for (uint8_t channel = 0; channel < 4; channel++) {
+      // A missing chip fails the config write before any wait, so the
+      // status, not conversionTimedOut(), says whether counts is real
+      int16_t counts;
+      adsStatus_t status = ads.readADC_SingleEnded(channel, &counts);
+      if (status != ADS1X15_OK) {
+        fprintf(stderr, "AIN%u: %s\n", channel, statusName(status));
+        continue;
+      }
+      printf("AIN%u: %6d  %.4fV\n", channel, counts, ads.computeVolts(counts));
+    }
+    printf("-----------------------------------------------------------\n");
+    delay(1000);
+  }
+}
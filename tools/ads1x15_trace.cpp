@@ -0,0 +1,177 @@
+/**************************************************************************/
+/*!
+    @file     ads1x15_trace.cpp
+
+    Host tool that profiles register traces printed by
+    Adafruit_ADS1X15::dumpTrace(): transaction counts, conversion-ready
+    polls per conversion and estimated bus occupancy. Given two traces,
+    e.g. one from the field and one from a new driver version replayed
+    against it with Adafruit_ADS1X15_ReplayTransport, it prints both
+    side by side.
+
+    Build from the library directory with:
+
+        g++ -O2 -I. -o ads1x15_trace tools/ads1x15_trace.cpp
+
+    Usage: ads1x15_trace trace.csv [other.csv]
+
+    BSD license, all text here must be included in any redistribution
+*/
+/**************************************************************************/
+#include "Adafruit_ADS1X15_Transport.h"
+
+#include <stdio.h>
+#include <vector>
+
+/** Bus clock the occupancy estimate is made for */
+#define BUS_HZ (400000UL)
+
+/** Bits on the bus, including START/STOP and ACKs, per transaction */
+#define WRITE_BITS (2 + 4 * 9)        ///< Address, pointer, 2 data bytes
+#define READ_BITS (2 + 3 * 9)         ///< Address, 2 data bytes
+#define POINTER_READ_BITS (3 + 5 * 9) ///< Pointer, repeated START, read
+
+/** Summary of one trace */
+struct Profile {
+  unsigned long transactions; ///< All transactions
+  unsigned long writes;       ///< Register writes
+  unsigned long reads[4];     ///< Reads per register
+  unsigned long pointers;     ///< Reads that also set the pointer
+  unsigned long errors;       ///< Failed transactions
+  unsigned long conversions;  ///< Config writes starting a conversion
+  unsigned long polls;        ///< Config reads while converting
+  unsigned long maxPolls;     ///< Most config reads for one conversion
+  unsigned long bits;         ///< Estimated bits on the bus
+  unsigned long span;         ///< First to last timestamp, in us
+};
+
+static bool load(const char *path, std::vector<adsTraceEntry_t> *trace) {
+  FILE *in = fopen(path, "r");
+  if (in == NULL) {
+    perror(path);
+    return false;
+  }
+  char line[80];
+  while (fgets(line, sizeof(line), in) != NULL) {
+    unsigned long timestamp;
+    unsigned reg, value, flags;
+    if (sscanf(line, "%lu,%u,%u,%u", &timestamp, &reg, &value, &flags) != 4) {
+      continue; // header line or serial noise
+    }
+    adsTraceEntry_t e;
+    e.timestamp = timestamp;
+    e.reg = reg;
+    e.value = value;
+    e.flags = flags;
+    trace->push_back(e);
+  }
+  fclose(in);
+  return true;
+}
+
+static Profile profile(const std::vector<adsTraceEntry_t> &trace) {
+  Profile p = Profile();
+  unsigned long polls = 0;
+  bool converting = false;
+
+  for (size_t i = 0; i < trace.size(); i++) {
+    const adsTraceEntry_t &e = trace[i];
+    uint8_t reg = e.reg & 0x03;
+    p.transactions++;
+    if (e.flags & ADS1X15_TRACE_ERROR) {
+      p.errors++;
+    }
+    if (!(e.flags & ADS1X15_TRACE_READ)) {
+      p.writes++;
+      p.bits += WRITE_BITS;
+      // Single-shot start: config register with the OS bit set
+      if (reg == 1 && (e.value & 0x8000)) {
+        p.conversions++;
+        converting = true;
+        polls = 0;
+      }
+      continue;
+    }
+
+    p.reads[reg]++;
+    if (e.flags & ADS1X15_TRACE_POINTER) {
+      p.pointers++;
+      p.bits += POINTER_READ_BITS;
+    } else {
+      p.bits += READ_BITS;
+    }
+    if (converting && reg == 1) {
+      p.polls++;
+      polls++;
+      if (polls > p.maxPolls) {
+        p.maxPolls = polls;
+      }
+      // OS bit set again: conversion done
+      converting = !(e.value & 0x8000);
+    }
+  }
+  if (trace.size() > 1) {
+    p.span = trace.back().timestamp - trace.front().timestamp;
+  }
+  return p;
+}
+
+static void row(const char *name, const Profile *p, size_t n,
+                unsigned long Profile::*field) {
+  printf("%-24s", name);
+  for (size_t i = 0; i < n; i++) {
+    printf("%12lu", p[i].*field);
+  }
+  printf("\n");
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2 || argc > 3) {
+    fprintf(stderr, "usage: %s trace.csv [other.csv]\n", argv[0]);
+    return 1;
+  }
+
+  Profile p[2];
+  size_t n = argc - 1;
+  for (size_t i = 0; i < n; i++) {
+    std::vector<adsTraceEntry_t> trace;
+    if (!load(argv[i + 1], &trace)) {
+      return 1;
+    }
+    p[i] = profile(trace);
+  }
+
+  row("transactions", p, n, &Profile::transactions);
+  row("register writes", p, n, &Profile::writes);
+  printf("%-24s", "conversion reads");
+  for (size_t i = 0; i < n; i++) {
+    printf("%12lu", p[i].reads[0]);
+  }
+  printf("\n%-24s", "config reads");
+  for (size_t i = 0; i < n; i++) {
+    printf("%12lu", p[i].reads[1]);
+  }
+  printf("\n");
+  row("pointer writes", p, n, &Profile::pointers);
+  row("errors", p, n, &Profile::errors);
+  row("conversions", p, n, &Profile::conversions);
+  row("max polls/conversion", p, n, &Profile::maxPolls);
+  printf("%-24s", "mean polls/conversion");
+  for (size_t i = 0; i < n; i++) {
+    printf("%12.2f",
+           p[i].conversions ? (double)p[i].polls / p[i].conversions : 0.0);
+  }
+  printf("\n");
+  row("trace span (us)", p, n, &Profile::span);
+  printf("%-24s", "bus busy at 400kHz (us)");
+  for (size_t i = 0; i < n; i++) {
+    printf("%12lu", (unsigned long)(p[i].bits * 1000000ULL / BUS_HZ));
+  }
+  printf("\n%-24s", "bus occupancy (%)");
+  for (size_t i = 0; i < n; i++) {
+    double busy = p[i].bits * 1e6 / BUS_HZ;
+    printf("%12.2f", p[i].span ? 100.0 * busy / p[i].span : 0.0);
+  }
+  printf("\n");
+  return 0;
+}